@@ -0,0 +1,145 @@
+/*
+Benchmark: Cache Coloring dos chunks das Pools
+
+Aloca um bloco por chunk (o primeiro bloco de cada chunk) em muitas chunks da mesma classe,
+e percorre esses blocos repetidamente. Sem coloring, todos caem no mesmo set da L1/L2.
+O percurso é uma cadeia de ponteiros (cada bloco aponta para o próximo), para expor a latência dos misses.
+Executa o mesmo percurso com coloring desligado e ligado, lendo os contadores de hardware
+(L1D misses / LLC misses) via perf_event_open quando disponíveis.
+
+Uso: make bench && ./bin/bench_cache_coloring
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "../include/pool.h"
+
+#define BLOCK_SIZE 512
+#define CHUNKS_PER_RUN 64
+#define ITERATIONS 20000
+
+typedef struct Counter {
+    int fd;
+    const char *name;
+} Counter;
+
+static u64 now_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int open_counter(u32 type, u64 config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void counter_start(Counter *c) {
+    if (c->fd < 0) return;
+    ioctl(c->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static u64 counter_stop(Counter *c) {
+    u64 value = 0;
+    if (c->fd < 0) return 0;
+    ioctl(c->fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(c->fd, &value, sizeof(value)) != sizeof(value)) return 0;
+    return value;
+}
+
+/*
+Guarda o primeiro bloco de CHUNKS_PER_RUN chunks novos. Os demais blocos ficam alocados, forçando chunks novos.
+Um chunk recém fatiado entrega seus blocos em ordem, então o primeiro bloco visto de cada zona é o seu início.
+O chunk ativo no momento da chamada é descartado (pode ter sido fatiado com outra configuração).
+ */
+static void collect_chunk_heads(Pool *pool, void **heads) {
+    void *last_zone = get_descriptor(pool_alloc(pool))->zone_header;
+    size_t found = 0;
+
+    while (found < CHUNKS_PER_RUN) {
+        void *block = pool_alloc(pool);
+        if (block == NULL) break;
+
+        void *zone = get_descriptor(block)->zone_header;
+        if (zone != last_zone) {
+            heads[found++] = block;
+            last_zone = zone;
+        }
+    }
+}
+
+static void run(const char *label, void **heads, Counter *counters, size_t n_counters) {
+    // Monta a cadeia circular: heads[c] -> heads[c+1]
+    for (size_t c = 0; c < CHUNKS_PER_RUN; c++) {
+        *(void**)heads[c] = heads[(c + 1) % CHUNKS_PER_RUN];
+    }
+
+    void **curr = (void**)heads[0];
+
+    for (size_t i = 0; i < n_counters; i++) counter_start(&counters[i]);
+    u64 start = now_nanos();
+
+    for (size_t it = 0; it < ITERATIONS * CHUNKS_PER_RUN; it++) {
+        curr = (void**)*curr;
+    }
+
+    u64 elapsed = now_nanos() - start;
+    printf("%-12s | %10.2f ms", label, elapsed / 1e6);
+    for (size_t i = 0; i < n_counters; i++) {
+        u64 value = counter_stop(&counters[i]);
+        if (counters[i].fd >= 0) printf(" | %s: %12lu", counters[i].name, value);
+    }
+    printf("\n");
+
+    if (curr == NULL) printf("unreachable\n"); // Impede que o percurso seja eliminado
+}
+
+int main() {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = RESERVED_MEMORY_REGION_SIZE * 32;
+    backend_init(&config);
+
+    Counter counters[] = {
+        { open_counter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)), "L1D misses" },
+        { open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES), "LLC misses" },
+    };
+    size_t n_counters = sizeof(counters) / sizeof(counters[0]);
+
+    if (counters[0].fd < 0 && counters[1].fd < 0) {
+        printf("perf_event_open indisponível: exibindo apenas tempo\n");
+    }
+
+    Pool *pool = pool_create(BLOCK_SIZE);
+
+    void *plain_heads[CHUNKS_PER_RUN];
+    void *colored_heads[CHUNKS_PER_RUN];
+
+    pool_set_cache_coloring(false);
+    collect_chunk_heads(pool, plain_heads);
+
+    pool_set_cache_coloring(true);
+    collect_chunk_heads(pool, colored_heads);
+
+    printf("block_size=%d, chunks=%d, iterations=%d\n", BLOCK_SIZE, CHUNKS_PER_RUN, ITERATIONS);
+    run("no coloring", plain_heads, counters, n_counters);
+    run("coloring", colored_heads, counters, n_counters);
+
+    for (size_t i = 0; i < n_counters; i++) {
+        if (counters[i].fd >= 0) close(counters[i].fd);
+    }
+    return 0;
+}
@@ -0,0 +1,617 @@
+/*
+Benchmark: Suíte padrão do alocador (mem_alloc/mem_free) contra a glibc (malloc/free)
+
+Cenários:
+  - size_classes:      alloc/free em lote, single-thread, de cada classe das pools e de algumas ordens do backend
+  - random_churn:      substitui slots aleatórios com tamanhos log-uniformes (8 B .. 32 KB)
+  - producer_consumer: produtores alocam, consumidores liberam (todo free é cross-thread)
+  - larson:            simulação de servidor (Larson): a cada época threads novas herdam e liberam os blocos das anteriores
+  - fragmentation:     aloca, libera 90% aleatório e aloca blocos maiores, amostrando RSS e bytes vivos ao longo do tempo
+  - huge_churn:        janela de blocos acima da ordem máxima do backend (256 KB .. 4 MB)
+
+Cada par (cenário, alocador) roda em um processo filho (fork): backend novo e RSS sem sobra da execução anterior.
+O filho manda os resultados ao pai por um pipe; o pai imprime a tabela e grava CSV/JSON.
+
+Uso: make bench                                   (resultados em bin/bench_results.csv e .json)
+     ./bin/bench_suite [--quick] [--only cenário] [--csv arquivo] [--json arquivo]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "../include/backend_manager.h"
+#include "../include/pool.h"
+#include "../include/mem.h"
+
+#define BENCH_RESERVE_SIZE ((size_t)1 << 30)
+#define BENCH_THREADS 4
+#define MAX_RESULTS 4096
+
+typedef struct Bench_Allocator {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*free)(void *ptr);
+} Bench_Allocator;
+
+// Uma linha do CSV / um objeto do JSON. 'step' >= 0 só nas séries temporais
+typedef struct Bench_Result {
+    char scenario[32];
+    char allocator[16];
+    char variant[32];
+    char metric[24];
+    char unit[12];
+    long step;
+    double value;
+} Bench_Result;
+
+typedef struct Bench_Scenario {
+    const char *name;
+    void (*run)(const Bench_Allocator *allocator);
+} Bench_Scenario;
+
+// DECLARAÇÕES
+static void scenario_size_classes(const Bench_Allocator *allocator);
+static void scenario_random_churn(const Bench_Allocator *allocator);
+static void scenario_producer_consumer(const Bench_Allocator *allocator);
+static void scenario_larson(const Bench_Allocator *allocator);
+static void scenario_fragmentation(const Bench_Allocator *allocator);
+static void scenario_huge_churn(const Bench_Allocator *allocator);
+
+static int result_fd = -1; // Pipe para o pai (no filho)
+static size_t scale = 1; // --quick divide as iterações por 10
+
+// ==========================
+//  AUXILIARES
+// ==========================
+
+static u64 now_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static u64 rng_next(u64 *state) {
+    u64 x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// Tamanho log-uniforme em [min, max]: tantos blocos pequenos quanto grandes por potência de 2
+static size_t rng_size(u64 *state, size_t min, size_t max) {
+    u32 min_log = 63 - __builtin_clzll(min);
+    u32 max_log = 63 - __builtin_clzll(max);
+    u32 log = min_log + (u32)(rng_next(state) % (max_log - min_log + 1));
+
+    size_t low = (size_t)1 << log;
+    size_t size = low + rng_next(state) % low;
+    if (size < min) size = min;
+    if (size > max) size = max;
+    return size;
+}
+
+static size_t current_rss() {
+    long pages_total = 0, pages_resident = 0;
+
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL) return 0;
+    if (fscanf(statm, "%ld %ld", &pages_total, &pages_resident) != 2) pages_resident = 0;
+    fclose(statm);
+
+    return (size_t)pages_resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static size_t peak_rss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (size_t)usage.ru_maxrss * 1024;
+}
+
+static void emit(const char *scenario, const Bench_Allocator *allocator, const char *variant,
+                 long step, const char *metric, double value, const char *unit) {
+    Bench_Result result;
+    memset(&result, 0, sizeof(result));
+    snprintf(result.scenario, sizeof(result.scenario), "%s", scenario);
+    snprintf(result.allocator, sizeof(result.allocator), "%s", allocator->name);
+    snprintf(result.variant, sizeof(result.variant), "%s", variant);
+    snprintf(result.metric, sizeof(result.metric), "%s", metric);
+    snprintf(result.unit, sizeof(result.unit), "%s", unit);
+    result.step = step;
+    result.value = value;
+
+    // sizeof(Bench_Result) < PIPE_BUF: cada write é atômico
+    if (write(result_fd, &result, sizeof(result)) != sizeof(result)) {
+        fprintf(stderr, "Error: Failed to send benchmark result [emit()]\n");
+    }
+}
+
+// Toca o bloco (primeiro e último byte) para que nenhum alocador ganhe por não encostar na memória
+static inline void touch(void *ptr, size_t size) {
+    if (ptr == NULL) return;
+    ((volatile u8*)ptr)[0] = 1;
+    ((volatile u8*)ptr)[size - 1] = 1;
+}
+
+// ==========================
+//  CENÁRIOS
+// ==========================
+
+#define SIZE_CLASS_BATCH 256
+
+static void run_size_class(const Bench_Allocator *allocator, size_t size, size_t operations) {
+    void *batch[SIZE_CLASS_BATCH];
+    size_t rounds = operations / SIZE_CLASS_BATCH;
+
+    u64 start = now_nanos();
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < SIZE_CLASS_BATCH; i++) {
+            batch[i] = allocator->alloc(size);
+            touch(batch[i], size);
+        }
+        for (size_t i = 0; i < SIZE_CLASS_BATCH; i++) {
+            allocator->free(batch[SIZE_CLASS_BATCH - 1 - i]);
+        }
+    }
+    u64 elapsed = now_nanos() - start;
+
+    char variant[32];
+    snprintf(variant, sizeof(variant), "size=%zu", size);
+    emit("size_classes", allocator, variant, -1, "ns_per_pair", (double)elapsed / (double)(rounds * SIZE_CLASS_BATCH), "ns");
+}
+
+static void scenario_size_classes(const Bench_Allocator *allocator) {
+    // Toda classe das pools (pequenas e médias), depois ordens do backend acima delas
+    for (size_t size = 8; size <= MAX_POOL_BLOCK_SIZE; size = pool_class_size(size) + 1) {
+        run_size_class(allocator, pool_class_size(size), 400000 / scale);
+    }
+
+    for (u32 order = get_order(MAX_POOL_BLOCK_SIZE + 1); order <= backend_max_order(); order++) {
+        run_size_class(allocator, REQUEST_SIZE_FROM_ORDER(order), 40000 / scale);
+    }
+}
+
+#define CHURN_SLOTS 4096
+
+static void scenario_random_churn(const Bench_Allocator *allocator) {
+    void *slots[CHURN_SLOTS] = {0};
+    size_t operations = 2000000 / scale;
+    u64 rng = 0x9E3779B97F4A7C15ULL;
+
+    u64 start = now_nanos();
+    for (size_t i = 0; i < operations; i++) {
+        size_t slot = rng_next(&rng) % CHURN_SLOTS;
+        size_t size = rng_size(&rng, 8, 32768);
+
+        allocator->free(slots[slot]);
+        slots[slot] = allocator->alloc(size);
+        touch(slots[slot], size);
+    }
+    u64 elapsed = now_nanos() - start;
+
+    for (size_t i = 0; i < CHURN_SLOTS; i++) allocator->free(slots[i]);
+
+    emit("random_churn", allocator, "8B-32KB", -1, "ns_per_pair", (double)elapsed / (double)operations, "ns");
+    emit("random_churn", allocator, "8B-32KB", -1, "peak_rss", (double)peak_rss(), "bytes");
+}
+
+// --- Produtor / Consumidor ---
+
+#define PC_BATCH 64
+#define PC_QUEUE 64
+
+typedef struct PC_Queue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    void **batches[PC_QUEUE];
+    size_t head, count;
+    size_t producers_left;
+} PC_Queue;
+
+typedef struct PC_Args {
+    const Bench_Allocator *allocator;
+    PC_Queue *queue;
+    size_t batches;
+    u64 seed;
+} PC_Args;
+
+static void *pc_producer(void *arg) {
+    PC_Args *args = (PC_Args*)arg;
+    PC_Queue *queue = args->queue;
+    u64 rng = args->seed;
+
+    for (size_t b = 0; b < args->batches; b++) {
+        void **batch = (void**)malloc(PC_BATCH * sizeof(void*)); // Transporte: mesmo custo para os dois alocadores
+        for (size_t i = 0; i < PC_BATCH; i++) {
+            size_t size = rng_size(&rng, 16, 512);
+            batch[i] = args->allocator->alloc(size);
+            touch(batch[i], size);
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        while (queue->count == PC_QUEUE) pthread_cond_wait(&queue->not_full, &queue->lock);
+        queue->batches[(queue->head + queue->count++) % PC_QUEUE] = batch;
+        pthread_cond_signal(&queue->not_empty);
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    queue->producers_left--;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return NULL;
+}
+
+static void *pc_consumer(void *arg) {
+    PC_Args *args = (PC_Args*)arg;
+    PC_Queue *queue = args->queue;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->count == 0 && queue->producers_left > 0) pthread_cond_wait(&queue->not_empty, &queue->lock);
+        if (queue->count == 0) {
+            pthread_mutex_unlock(&queue->lock);
+            return NULL;
+        }
+        void **batch = queue->batches[queue->head];
+        queue->head = (queue->head + 1) % PC_QUEUE;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+        pthread_mutex_unlock(&queue->lock);
+
+        for (size_t i = 0; i < PC_BATCH; i++) args->allocator->free(batch[i]);
+        free(batch);
+    }
+}
+
+static void scenario_producer_consumer(const Bench_Allocator *allocator) {
+    const size_t producers = BENCH_THREADS / 2;
+    const size_t consumers = BENCH_THREADS / 2;
+    size_t batches = 20000 / scale;
+
+    PC_Queue queue;
+    memset(&queue, 0, sizeof(queue));
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+    queue.producers_left = producers;
+
+    pthread_t threads[BENCH_THREADS];
+    PC_Args args[BENCH_THREADS];
+
+    u64 start = now_nanos();
+    for (size_t i = 0; i < producers + consumers; i++) {
+        args[i] = (PC_Args){ allocator, &queue, batches, 0x243F6A8885A308D3ULL + i };
+        pthread_create(&threads[i], NULL, (i < producers) ? pc_producer : pc_consumer, &args[i]);
+    }
+    for (size_t i = 0; i < producers + consumers; i++) pthread_join(threads[i], NULL);
+    u64 elapsed = now_nanos() - start;
+
+    double pairs = (double)(producers * batches * PC_BATCH);
+    char variant[32];
+    snprintf(variant, sizeof(variant), "threads=%zu+%zu", producers, consumers);
+    emit("producer_consumer", allocator, variant, -1, "ns_per_pair", (double)elapsed / pairs, "ns");
+    emit("producer_consumer", allocator, variant, -1, "peak_rss", (double)peak_rss(), "bytes");
+}
+
+// --- Larson ---
+
+#define LARSON_SLOTS 1000
+#define LARSON_EPOCHS 4
+
+typedef struct Larson_Args {
+    const Bench_Allocator *allocator;
+    void **slots; // Herdados da thread da época anterior
+    size_t rounds;
+    u64 seed;
+} Larson_Args;
+
+static void *larson_worker(void *arg) {
+    Larson_Args *args = (Larson_Args*)arg;
+    u64 rng = args->seed;
+
+    for (size_t i = 0; i < args->rounds; i++) {
+        size_t slot = rng_next(&rng) % LARSON_SLOTS;
+        size_t size = 16 + rng_next(&rng) % (1024 - 16 + 1);
+
+        args->allocator->free(args->slots[slot]);
+        args->slots[slot] = args->allocator->alloc(size);
+        touch(args->slots[slot], size);
+    }
+
+    args->seed = rng;
+    return NULL;
+}
+
+static void scenario_larson(const Bench_Allocator *allocator) {
+    size_t rounds = 400000 / scale;
+
+    void **slots = (void**)calloc(BENCH_THREADS * LARSON_SLOTS, sizeof(void*));
+    Larson_Args args[BENCH_THREADS];
+    pthread_t threads[BENCH_THREADS];
+
+    for (size_t t = 0; t < BENCH_THREADS; t++) {
+        args[t] = (Larson_Args){ allocator, slots + t * LARSON_SLOTS, rounds, 0x13198A2E03707344ULL + t };
+    }
+
+    // Cada época cria threads novas; a thread t herda os slots da thread (t + 1) da época anterior
+    u64 start = now_nanos();
+    for (size_t epoch = 0; epoch < LARSON_EPOCHS; epoch++) {
+        for (size_t t = 0; t < BENCH_THREADS; t++) {
+            args[t].slots = slots + ((t + epoch) % BENCH_THREADS) * LARSON_SLOTS;
+            pthread_create(&threads[t], NULL, larson_worker, &args[t]);
+        }
+        for (size_t t = 0; t < BENCH_THREADS; t++) pthread_join(threads[t], NULL);
+    }
+    u64 elapsed = now_nanos() - start;
+
+    for (size_t i = 0; i < BENCH_THREADS * LARSON_SLOTS; i++) allocator->free(slots[i]);
+    free(slots);
+
+    double operations = (double)(LARSON_EPOCHS * BENCH_THREADS * rounds);
+    char variant[32];
+    snprintf(variant, sizeof(variant), "threads=%d", BENCH_THREADS);
+    emit("larson", allocator, variant, -1, "ops_per_sec", operations / ((double)elapsed / 1e9), "ops/s");
+    emit("larson", allocator, variant, -1, "peak_rss", (double)peak_rss(), "bytes");
+}
+
+// --- Fragmentação ---
+
+#define FRAG_SAMPLES_PER_PHASE 20
+
+typedef struct Frag_State {
+    const Bench_Allocator *allocator;
+    long step;
+    size_t live_bytes;
+} Frag_State;
+
+static void frag_sample(Frag_State *state, const char *phase) {
+    emit("fragmentation", state->allocator, phase, state->step, "rss", (double)current_rss(), "bytes");
+    emit("fragmentation", state->allocator, phase, state->step, "live", (double)state->live_bytes, "bytes");
+    state->step++;
+}
+
+static void scenario_fragmentation(const Bench_Allocator *allocator) {
+    size_t objects = 200000 / scale;
+    void **ptrs = (void**)calloc(objects, sizeof(void*));
+    size_t *sizes = (size_t*)calloc(objects, sizeof(size_t));
+    size_t sample_every = objects / FRAG_SAMPLES_PER_PHASE;
+    u64 rng = 0xA4093822299F31D0ULL;
+
+    Frag_State state = { allocator, 0, 0 };
+    size_t baseline = current_rss();
+    frag_sample(&state, "start");
+
+    // Fase 1: muitos blocos pequenos
+    for (size_t i = 0; i < objects; i++) {
+        sizes[i] = rng_size(&rng, 16, 512);
+        ptrs[i] = allocator->alloc(sizes[i]);
+        touch(ptrs[i], sizes[i]);
+        state.live_bytes += sizes[i];
+        if ((i + 1) % sample_every == 0) frag_sample(&state, "fill");
+    }
+    size_t filled_bytes = state.live_bytes;
+
+    // Fase 2: libera ~90% em ordem aleatória, sobrevivem blocos espalhados
+    for (size_t i = 0; i < objects; i++) {
+        if (rng_next(&rng) % 10 != 0) {
+            allocator->free(ptrs[i]);
+            ptrs[i] = NULL;
+            state.live_bytes -= sizes[i];
+        }
+        if ((i + 1) % sample_every == 0) frag_sample(&state, "free_90");
+    }
+
+    // Fase 3: blocos maiores até voltar ao volume da fase 1 (só reaproveita o buraco se o alocador souber)
+    size_t large_count = 0;
+    void **large = (void**)calloc(objects, sizeof(void*));
+    size_t large_target = filled_bytes - state.live_bytes;
+    size_t large_bytes = 0;
+    size_t next_sample = large_target / FRAG_SAMPLES_PER_PHASE;
+
+    while (large_bytes < large_target && large_count < objects) {
+        size_t size = rng_size(&rng, 1024, 16384);
+        large[large_count] = allocator->alloc(size);
+        touch(large[large_count], size);
+        large_count++;
+        large_bytes += size;
+        state.live_bytes += size;
+        if (large_bytes >= next_sample) {
+            frag_sample(&state, "refill_large");
+            next_sample += large_target / FRAG_SAMPLES_PER_PHASE;
+        }
+    }
+
+    size_t final_rss = current_rss();
+    emit("fragmentation", allocator, "summary", -1, "peak_rss", (double)peak_rss(), "bytes");
+    emit("fragmentation", allocator, "summary", -1, "final_rss_over_live",
+         (double)(final_rss - baseline) / (double)state.live_bytes, "ratio");
+
+    for (size_t i = 0; i < large_count; i++) allocator->free(large[i]);
+    for (size_t i = 0; i < objects; i++) allocator->free(ptrs[i]);
+    free(large);
+    free(sizes);
+    free(ptrs);
+}
+
+// --- Huge ---
+
+#define HUGE_WINDOW 8
+
+static void scenario_huge_churn(const Bench_Allocator *allocator) {
+    void *window[HUGE_WINDOW] = {0};
+    size_t operations = 4000 / scale;
+    u64 rng = 0x082EFA98EC4E6C89ULL;
+
+    u64 start = now_nanos();
+    for (size_t i = 0; i < operations; i++) {
+        size_t slot = rng_next(&rng) % HUGE_WINDOW;
+        size_t size = rng_size(&rng, (size_t)256 << 10, (size_t)4 << 20);
+
+        allocator->free(window[slot]);
+        window[slot] = allocator->alloc(size);
+        touch(window[slot], size);
+    }
+    u64 elapsed = now_nanos() - start;
+
+    for (size_t i = 0; i < HUGE_WINDOW; i++) allocator->free(window[i]);
+
+    emit("huge_churn", allocator, "256KB-4MB", -1, "ns_per_pair", (double)elapsed / (double)operations, "ns");
+    emit("huge_churn", allocator, "256KB-4MB", -1, "peak_rss", (double)peak_rss(), "bytes");
+}
+
+// ==========================
+//  DRIVER
+// ==========================
+
+static const Bench_Scenario scenarios[] = {
+    { "size_classes",      scenario_size_classes },
+    { "random_churn",      scenario_random_churn },
+    { "producer_consumer", scenario_producer_consumer },
+    { "larson",            scenario_larson },
+    { "fragmentation",     scenario_fragmentation },
+    { "huge_churn",        scenario_huge_churn },
+};
+
+static const Bench_Allocator allocators[] = {
+    { "allocator", mem_alloc, mem_free },
+    { "glibc",     malloc,    free },
+};
+
+// Roda o cenário num filho e acumula os resultados recebidos em 'results'
+static size_t run_isolated(const Bench_Scenario *scenario, const Bench_Allocator *allocator,
+                           Bench_Result *results, size_t count) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return count;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        result_fd = fds[1];
+
+        Backend_Config config = backend_default_config();
+        config.reserve_size = BENCH_RESERVE_SIZE;
+        if (!backend_init(&config)) _exit(1);
+
+        scenario->run(allocator);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    Bench_Result result;
+    while (read(fds[0], &result, sizeof(result)) == sizeof(result)) {
+        if (count < MAX_RESULTS) results[count++] = result;
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Error: scenario '%s' failed for '%s'\n", scenario->name, allocator->name);
+    }
+
+    return count;
+}
+
+static void write_csv(const char *path, const Bench_Result *results, size_t count) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror(path);
+        return;
+    }
+
+    fprintf(out, "scenario,allocator,variant,step,metric,value,unit\n");
+    for (size_t i = 0; i < count; i++) {
+        const Bench_Result *r = &results[i];
+        fprintf(out, "%s,%s,%s,%ld,%s,%.6g,%s\n", r->scenario, r->allocator, r->variant, r->step, r->metric, r->value, r->unit);
+    }
+    fclose(out);
+}
+
+static void write_json(const char *path, const Bench_Result *results, size_t count) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror(path);
+        return;
+    }
+
+    fprintf(out, "{\n  \"quick\": %s,\n  \"results\": [\n", (scale > 1) ? "true" : "false");
+    for (size_t i = 0; i < count; i++) {
+        const Bench_Result *r = &results[i];
+        fprintf(out, "    {\"scenario\": \"%s\", \"allocator\": \"%s\", \"variant\": \"%s\", \"step\": %ld, "
+                     "\"metric\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}%s\n",
+                r->scenario, r->allocator, r->variant, r->step, r->metric, r->value, r->unit,
+                (i + 1 < count) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+}
+
+// Tabela lado a lado (sem as séries temporais, que ficam só no CSV/JSON)
+static void print_summary(const Bench_Result *results, size_t count) {
+    printf("| %-18s | %-16s | %-20s | %14s | %14s | %-6s |\n", "Cenário", "Variante", "Métrica", "allocator", "glibc", "Unid.");
+
+    for (size_t i = 0; i < count; i++) {
+        const Bench_Result *r = &results[i];
+        if (r->step >= 0 || strcmp(r->allocator, allocators[0].name) != 0) continue;
+
+        double other = 0;
+        for (size_t j = 0; j < count; j++) {
+            const Bench_Result *o = &results[j];
+            if (o->step < 0 && strcmp(o->allocator, allocators[1].name) == 0 && strcmp(o->scenario, r->scenario) == 0 &&
+                strcmp(o->variant, r->variant) == 0 && strcmp(o->metric, r->metric) == 0) {
+                other = o->value;
+                break;
+            }
+        }
+
+        printf("| %-18s | %-16s | %-20s | %14.2f | %14.2f | %-6s |\n", r->scenario, r->variant, r->metric, r->value, other, r->unit);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *csv_path = "bench_results.csv";
+    const char *json_path = "bench_results.json";
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) scale = 10;
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv_path = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_path = argv[++i];
+        else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) only = argv[++i];
+        else {
+            fprintf(stderr, "Uso: %s [--quick] [--only cenário] [--csv arquivo] [--json arquivo]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Bench_Result *results = (Bench_Result*)calloc(MAX_RESULTS, sizeof(Bench_Result));
+    size_t count = 0;
+
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        if (only != NULL && strcmp(only, scenarios[s].name) != 0) continue;
+
+        for (size_t a = 0; a < sizeof(allocators) / sizeof(allocators[0]); a++) {
+            printf("Rodando %s [%s]...\n", scenarios[s].name, allocators[a].name);
+            count = run_isolated(&scenarios[s], &allocators[a], results, count);
+        }
+    }
+
+    print_summary(results, count);
+    write_csv(csv_path, results, count);
+    write_json(json_path, results, count);
+    printf("Resultados: %s, %s\n", csv_path, json_path);
+
+    free(results);
+    return 0;
+}
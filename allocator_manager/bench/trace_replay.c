@@ -0,0 +1,295 @@
+/*
+Replay de uma trace gravada com trace_start()/trace_stop()
+
+Re-executa os eventos em uma única thread, na ordem de tempo da gravação (determinístico: a mesma
+trace e a mesma configuração produzem a mesma sequência de chamadas), contra o alocador com a
+configuração escolhida ou contra a glibc. Cada bloco alocado tem uma escrita por página, para o RSS
+refletir o uso real. Relata tempo total, pico de RSS e fragmentação (1 - bytes vivos / RSS).
+
+Uso: make bench-build && ./bin/trace_replay arquivo.trace [opções]
+  --glibc              malloc/calloc/free no lugar do alocador
+  --engine bins|bitmap engine do backend
+  --max-order N        ordem máxima do backend (ordem dos chunks das pools)
+  --page-size N        tamanho da página do backend
+  --reserve-mb N       tamanho da reserva do backend
+  --no-lazy            desliga o coalescing tardio (engine bins)
+  --percpu             liga o cache por CPU das pools pequenas
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "../include/backend_manager.h"
+#include "../include/pool.h"
+#include "../include/trace.h"
+
+#define RSS_SAMPLE_INTERVAL 1024 // Eventos entre leituras de RSS
+
+// Objeto vivo no replay, indexado pelo endereço da gravação (endereçamento aberto)
+typedef struct Replay_Object {
+    u64 address; // 0 = vazio, 1 = removido
+    void *ptr;
+    size_t size;
+} Replay_Object;
+
+typedef struct Replay_Table {
+    Replay_Object *slots;
+    size_t capacity; // Potência de 2
+} Replay_Table;
+
+typedef struct Replay_Stats {
+    u64 elapsed_ns;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    size_t peak_rss;
+    size_t rss_at_peak_live;
+    size_t final_rss;
+    size_t unmatched_frees; // Free sem alocação correspondente na trace (ex.: eventos perdidos)
+    size_t failed_allocs;
+} Replay_Stats;
+
+static bool use_glibc = false;
+
+// ==========================
+//  AUXILIARES
+// ==========================
+
+static u64 now_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t current_rss() {
+    long pages_total = 0, pages_resident = 0;
+
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL) return 0;
+    if (fscanf(statm, "%ld %ld", &pages_total, &pages_resident) != 2) pages_resident = 0;
+    fclose(statm);
+
+    return (size_t)pages_resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static size_t rss_since(size_t baseline) {
+    size_t rss = current_rss();
+    return (rss > baseline) ? rss - baseline : 0;
+}
+
+static inline size_t hash_address(u64 address) {
+    address ^= address >> 33;
+    address *= 0xFF51AFD7ED558CCDULL;
+    address ^= address >> 33;
+    return (size_t)address;
+}
+
+// Tabela com mmap: não disputa o heap com o alocador medido
+static bool table_init(Replay_Table *table, size_t max_objects) {
+    size_t capacity = 1024;
+    while (capacity < max_objects * 2) capacity <<= 1;
+
+    void *slots = mmap(NULL, capacity * sizeof(Replay_Object), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slots == MAP_FAILED) return false;
+
+    table->slots = (Replay_Object*)slots;
+    table->capacity = capacity;
+    return true;
+}
+
+static Replay_Object *table_find(Replay_Table *table, u64 address, bool insert) {
+    size_t mask = table->capacity - 1;
+    Replay_Object *tombstone = NULL;
+
+    for (size_t i = hash_address(address) & mask;; i = (i + 1) & mask) {
+        Replay_Object *slot = &table->slots[i];
+        if (slot->address == address) return slot;
+
+        if (slot->address == 1 && tombstone == NULL) tombstone = slot;
+        if (slot->address == 0) {
+            if (!insert) return NULL;
+            return (tombstone != NULL) ? tombstone : slot;
+        }
+    }
+}
+
+// ==========================
+//  REPLAY
+// ==========================
+
+static void *replay_alloc(const Trace_Event *event) {
+    u8 kind = event->op & TRACE_OP_MASK;
+    bool zeroed = (event->op & TRACE_FLAG_ZEROED) != 0;
+
+    if (use_glibc) {
+        return zeroed ? calloc(1, event->size) : malloc(event->size);
+    }
+
+    if (kind == TRACE_OP_PALLOC) {
+        if (zeroed) return pcalloc(event->size);
+        return palloc_hint(event->size, (event->op & TRACE_FLAG_LONG_LIVED) ? LIFETIME_LONG : LIFETIME_SHORT);
+    }
+
+    Page_Owner owner = (Page_Owner)(event->op >> TRACE_OWNER_SHIFT);
+    return zeroed ? backend_calloc(event->size, owner) : backend_alloc(event->size, owner);
+}
+
+static void replay_free(const Trace_Event *event, void *ptr) {
+    if (use_glibc) {
+        free(ptr);
+    } else if ((event->op & TRACE_OP_MASK) == TRACE_OP_POOL_FREE) {
+        pool_free(ptr);
+    } else {
+        backend_free(ptr);
+    }
+}
+
+static void replay(const Trace_Event *events, size_t count, Replay_Table *table, Replay_Stats *stats) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t baseline = current_rss();
+    u64 start = now_nanos();
+
+    for (size_t i = 0; i < count; i++) {
+        const Trace_Event *event = &events[i];
+        u8 kind = event->op & TRACE_OP_MASK;
+
+        if (kind == TRACE_OP_PALLOC || kind == TRACE_OP_BACKEND_ALLOC) {
+            void *ptr = replay_alloc(event);
+            if (ptr == NULL) {
+                stats->failed_allocs++;
+                continue;
+            }
+
+            // Uma escrita por página: o RSS passa a contar o bloco como o programa original contaria
+            for (size_t offset = 0; offset < event->size; offset += page_size) ((volatile u8*)ptr)[offset] = 1;
+
+            // Endereço já vivo: o free dele se perdeu na gravação, o bloco antigo fica esquecido
+            Replay_Object *object = table_find(table, event->address, true);
+            if (object->address == event->address) stats->live_bytes -= object->size;
+
+            object->address = event->address;
+            object->ptr = ptr;
+            object->size = event->size;
+
+            stats->live_bytes += event->size;
+            if (stats->live_bytes > stats->peak_live_bytes) {
+                stats->peak_live_bytes = stats->live_bytes;
+                stats->rss_at_peak_live = 0; // Lido na próxima amostra
+            }
+        } else {
+            Replay_Object *object = table_find(table, event->address, false);
+            if (object == NULL) {
+                stats->unmatched_frees++;
+                continue;
+            }
+
+            replay_free(event, object->ptr);
+            stats->live_bytes -= object->size;
+            object->address = 1;
+        }
+
+        if (i % RSS_SAMPLE_INTERVAL == 0) {
+            size_t rss = rss_since(baseline);
+            if (rss > stats->peak_rss) stats->peak_rss = rss;
+            if (stats->rss_at_peak_live == 0) stats->rss_at_peak_live = rss;
+        }
+    }
+
+    stats->elapsed_ns = now_nanos() - start;
+    stats->final_rss = rss_since(baseline);
+    if (stats->final_rss > stats->peak_rss) stats->peak_rss = stats->final_rss;
+    if (stats->rss_at_peak_live == 0) stats->rss_at_peak_live = stats->final_rss;
+}
+
+// ==========================
+//  MAIN
+// ==========================
+
+static void usage(const char *program) {
+    fprintf(stderr, "Uso: %s arquivo.trace [--glibc] [--engine bins|bitmap] [--max-order N] [--page-size N] "
+                    "[--reserve-mb N] [--no-lazy] [--percpu]\n", program);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)1 << 30;
+    bool lazy = true;
+    bool percpu = false;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--glibc") == 0) use_glibc = true;
+        else if (strcmp(argv[i], "--no-lazy") == 0) lazy = false;
+        else if (strcmp(argv[i], "--percpu") == 0) percpu = true;
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            i++;
+            config.engine = (strcmp(argv[i], "bitmap") == 0) ? BACKEND_ENGINE_BITMAP : BACKEND_ENGINE_BINS;
+        }
+        else if (strcmp(argv[i], "--max-order") == 0 && i + 1 < argc) config.max_order = (u32)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) config.page_size = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--reserve-mb") == 0 && i + 1 < argc) config.reserve_size = (size_t)atol(argv[++i]) << 20;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    size_t count = 0;
+    u32 threads = 0;
+    Trace_Event *events = trace_load(argv[1], &count, &threads);
+    if (events == NULL) return 1;
+
+    Replay_Table table;
+    if (!table_init(&table, count)) {
+        fprintf(stderr, "Error: Could not allocate replay table\n");
+        return 1;
+    }
+
+    if (!use_glibc) {
+        if (!backend_init(&config)) return 1;
+        if (REQUEST_SIZE_FROM_ORDER(backend_max_order()) < pool_min_chunk_size()) {
+            fprintf(stderr, "Error: --max-order %u is too small for the pool chunks (%zu bytes)\n",
+                    backend_max_order(), pool_min_chunk_size());
+            return 1;
+        }
+        backend_set_lazy_coalescing(lazy);
+        if (percpu && !pool_enable_percpu_cache()) {
+            fprintf(stderr, "Warning: per-CPU cache unavailable, replaying without it\n");
+        }
+    }
+
+    Replay_Stats stats = {0};
+    replay(events, count, &table, &stats);
+
+    printf("Trace: %s (%zu eventos, %u threads gravadas, replay em 1 thread)\n", argv[1], count, threads);
+    if (use_glibc) {
+        printf("Alocador: glibc\n");
+    } else {
+        printf("Alocador: engine=%s page_size=%zu max_order=%u reserve=%zuMB lazy=%d percpu=%d\n",
+               (config.engine == BACKEND_ENGINE_BITMAP) ? "bitmap" : "bins", config.page_size, config.max_order,
+               config.reserve_size >> 20, lazy, percpu);
+    }
+
+    double peak_fragmentation = stats.rss_at_peak_live ? 1.0 - (double)stats.peak_live_bytes / (double)stats.rss_at_peak_live : 0.0;
+    double final_fragmentation = stats.final_rss ? 1.0 - (double)stats.live_bytes / (double)stats.final_rss : 0.0;
+
+    printf("Tempo:              %.3f ms (%.1f ns/evento)\n", stats.elapsed_ns / 1e6, count ? (double)stats.elapsed_ns / (double)count : 0.0);
+    printf("Pico de RSS:        %.2f MB\n", stats.peak_rss / (1024.0 * 1024.0));
+    printf("Pico de bytes vivos: %.2f MB (RSS nesse ponto: %.2f MB, fragmentação %.1f%%)\n",
+           stats.peak_live_bytes / (1024.0 * 1024.0), stats.rss_at_peak_live / (1024.0 * 1024.0), peak_fragmentation * 100.0);
+    printf("Final:              %.2f MB vivos, %.2f MB de RSS (fragmentação %.1f%%)\n",
+           stats.live_bytes / (1024.0 * 1024.0), stats.final_rss / (1024.0 * 1024.0), final_fragmentation * 100.0);
+    if (stats.unmatched_frees || stats.failed_allocs) {
+        printf("Frees sem alocação: %zu | Alocações que falharam: %zu\n", stats.unmatched_frees, stats.failed_allocs);
+    }
+
+    trace_free_events(events, count);
+    return 0;
+}
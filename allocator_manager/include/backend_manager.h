@@ -3,14 +3,16 @@
 #include "utilities.h"
 
 
-#define PAGE_SIZE 4096
+#define PAGE_SIZE 4096 // Tamanho de página padrão (Backend_Config.page_size = 0)
 #define RESERVED_MEMORY_REGION_SIZE (size_t)(1024 * 1024 * 2)
-#define MAX_BIN_ORDER 5 // Tamanho máximo da Bin é de 256 KB
-#define MAX_DEFAULT_ALLOCATION_SIZE (PAGE_SIZE * (1 << MAX_BIN_ORDER))
+#define MAX_BIN_ORDER 5 // Ordem máxima padrão: 32 páginas (128 KB)
+#define MAX_BIN_ORDER_LIMIT 13 // Maior ordem configurável: 8192 páginas (32 MB com páginas de 4 KB)
 #define HUGE_MAGIC_NUMBER 0xF22CAA33CE
 #define DEFAULT_ALIGNMENT (2 * sizeof(void*))
+#define LAZY_COALESCE_CACHE_SIZE 8 // Blocos liberados mantidos sem fundir, por ordem
+#define BACKEND_PAGE_FREE 0xFF // backend_get_page_map(): página livre (no lugar do Page_Owner)
 
-#define REQUEST_SIZE_FROM_ORDER(order) ((1 << (order)) * PAGE_SIZE)
+#define REQUEST_SIZE_FROM_ORDER(order) (((size_t)1 << (order)) * backend_page_size())
 
 
 typedef enum Page_Owner {
@@ -21,9 +23,51 @@ typedef enum Page_Owner {
     OWNER_DEBUG
 } Page_Owner;
 
+// Mecanismo de controle das páginas livres do backend
+typedef enum Backend_Engine {
+    BACKEND_ENGINE_BINS,    // Listas duplamente encadeadas por ordem (Page_Bin), com lock global
+    BACKEND_ENGINE_BITMAP   // Bitmap por ordem, atualizado com CAS, sem lock global
+} Backend_Engine;
+
+// Geometria do backend, fixada no backend_init()
+typedef struct Backend_Config {
+    size_t reserve_size;    // Bytes reservados do SO (metadados + páginas)
+    size_t page_size;       // Potência de 2, múltipla da página do sistema. 0 = PAGE_SIZE
+    u32 max_order;          // Maior bloco servido pela reserva = page_size << max_order; acima disso, mmap próprio
+    Backend_Engine engine;
+} Backend_Config;
+
+// Contadores do caminho de split/merge do engine BINS
+typedef struct Backend_Coalesce_Stats {
+    u64 lazy_hits;       // Allocs atendidos pelo cache de coalescing tardio
+    u64 deferred_frees;  // Frees que entraram no cache sem fundir
+    u64 lazy_flushes;    // Esvaziamentos (parciais ou totais) do cache
+    u64 splits;
+    u64 merges;
+    u64 bin_removes;
+} Backend_Coalesce_Stats;
+
+// Fragmentação externa das páginas já tiradas da reserva
+typedef struct Backend_Fragmentation {
+    size_t committed_pages; // Páginas da reserva fora do PROT_NONE (as huge ficam de fora)
+    size_t free_pages;
+    size_t free_blocks[MAX_BIN_ORDER_LIMIT+1];   // Blocos livres por ordem, incluindo o cache de coalescing tardio
+    double unusable_free[MAX_BIN_ORDER_LIMIT+1]; // Fração das páginas livres em blocos menores que a ordem: não atendem um pedido dela
+    double external_fragmentation;               // unusable_free[max_order]: páginas livres que não formam um bloco de ordem máxima
+    size_t huge_allocations;
+    size_t huge_bytes;                           // Incluindo a página de header
+} Backend_Fragmentation;
+
+// Qual bloco livre uma Page_Bin entrega (engine BINS)
+typedef enum Page_Policy {
+    PAGE_POLICY_LIFO,             // O último bloco liberado
+    PAGE_POLICY_ADDRESS_ORDERED   // O bloco de menor endereço (padrão)
+} Page_Policy;
+
 typedef struct Page_Descriptor {
     u8 flags;
     u8 order;
+    u16 requested_pages; // Bloco alocado: páginas pedidas ao backend (<= 1 << order); ocupa o padding antes do owner_id
     Page_Owner owner_id;    
     
     void *zone_header;
@@ -32,9 +76,23 @@ typedef struct Page_Descriptor {
     struct Page_Descriptor *prev;
 } Page_Descriptor;
 
-void backend_init(size_t total_memory_size);
+Backend_Config backend_default_config();
+bool backend_init(const Backend_Config *config);
+size_t backend_page_size();
+u32 backend_max_order();
 void *backend_alloc(size_t size, Page_Owner owner);
+void *backend_alloc_fresh(size_t size, Page_Owner owner, bool *zeroed);
+void *backend_calloc(size_t size, Page_Owner owner);
 void backend_free(void *ptr);
+size_t backend_usable_size(void *ptr);
+bool is_huge_allocation(void *ptr);
+void backend_set_lazy_coalescing(bool enabled);
+void backend_set_page_policy(Page_Policy policy);
+size_t backend_purge();
+Backend_Coalesce_Stats backend_get_coalesce_stats();
+Backend_Fragmentation backend_get_fragmentation();
+size_t backend_get_page_map(u8 *owners, size_t max_pages);
+size_t backend_page_index(void *ptr);
 
 Page_Descriptor *get_descriptor(void *ptr);
 void *get_address(Page_Descriptor *node);
@@ -2,19 +2,100 @@
 #define BENCHMARK_H
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
 
-// Estrutura para guardar os dados de cada função
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_HAS_TSC 1
+#else
+#define BENCHMARK_HAS_TSC 0
+#endif
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define BENCHMARK_HAS_PERF 1
+#else
+#define BENCHMARK_HAS_PERF 0
+#endif
+
+/*
+Profiler por ponto de medição (BENCHMARK_START_NAME ... BENCHMARK_END):
+  - cada thread grava no seu próprio buffer (sem lock nem atômicos no caminho da amostra);
+    os buffers são somados só no relatório
+  - tempo em ticks do TSC, convertido para ns pela calibração contra CLOCK_MONOTONIC
+  - histograma log-linear (estilo HDR): 16 sub-buckets por potência de 2, erro relativo <= 6.25%
+  - o custo do próprio par de leituras do relógio é medido e descontado no relatório
+  - opcional (benchmark_enable_counters): contadores de hardware por ponto, lidos em grupo via perf_event_open
+    no START e no END da thread. Sem perf_event_open (ex.: container), o relatório fica só com tempo.
+benchmark_print_stats() deve ser chamado com as threads medidas já terminadas (lê os buffers sem lock).
+ */
+
+#define BENCHMARK_MAX_SITES 64
+#define BENCHMARK_SUB_BUCKET_BITS 4
+#define BENCHMARK_SUB_BUCKETS (1 << BENCHMARK_SUB_BUCKET_BITS)
+#define BENCHMARK_MAX_MAGNITUDE 48 // Amostras >= 2^48 ticks caem no último bucket
+#define BENCHMARK_BUCKETS ((BENCHMARK_MAX_MAGNITUDE - BENCHMARK_SUB_BUCKET_BITS + 1) * BENCHMARK_SUB_BUCKETS)
+#define BENCHMARK_CALIBRATION_NS 10000000ULL // Janela mínima de calibração do TSC (10 ms)
+
+// Contadores de hardware do grupo perf_event_open (o primeiro é o líder)
+typedef enum Benchmark_Counter {
+    BENCHMARK_CYCLES,
+    BENCHMARK_INSTRUCTIONS,
+    BENCHMARK_L1D_MISSES,
+    BENCHMARK_LLC_MISSES,
+    BENCHMARK_DTLB_MISSES,
+    BENCHMARK_BRANCH_MISSES,
+    BENCHMARK_COUNTER_COUNT
+} Benchmark_Counter;
+
+typedef struct Benchmark_Counter_Values {
+    bool valid;
+    uint64_t values[BENCHMARK_COUNTER_COUNT];
+} Benchmark_Counter_Values;
+
+// Ponto de medição (um por BENCHMARK_START_NAME)
 typedef struct Function_Profile {
     const char *func_name;
-    uint64_t total_ns;      // Acumulador de tempo total em nanosegundos
-    uint64_t func_calls;    // Contador de chamadas
-    struct Function_Profile *next;
+    int index; // 0 = ainda não registrado, -1 = sem espaço, senão posição + 1 em _benchmark_sites
 } Function_Profile;
 
-// Cabeça da lista global (começa vazia)
-static Function_Profile *_global_benchmark = NULL;
+typedef struct Benchmark_Histogram {
+    uint64_t count;
+    uint64_t total_ticks;
+    uint64_t max_ticks;
+    uint64_t counter_samples; // Amostras com contadores válidos
+    uint64_t counters[BENCHMARK_COUNTER_COUNT];
+    uint32_t buckets[BENCHMARK_BUCKETS];
+} Benchmark_Histogram;
+
+// Buffer de uma thread: um histograma por ponto, alocado na primeira amostra
+typedef struct Benchmark_Thread_Buffer {
+    Benchmark_Histogram *sites[BENCHMARK_MAX_SITES];
+
+    // Grupo perf_event_open da thread (aberto na primeira leitura)
+    int perf_state; // 0 = não tentado, 1 = aberto, -1 = falhou
+    int perf_leader;
+    int perf_slots[BENCHMARK_COUNTER_COUNT]; // Posição do contador na leitura do grupo, -1 se não abriu
+
+    struct Benchmark_Thread_Buffer *next;
+} Benchmark_Thread_Buffer;
+
+static pthread_mutex_t _benchmark_lock = PTHREAD_MUTEX_INITIALIZER;
+static Function_Profile *_benchmark_sites[BENCHMARK_MAX_SITES];
+static int _benchmark_site_count = 0;
+static Benchmark_Thread_Buffer *_benchmark_threads = NULL; // Buffers de todas as threads (nunca liberados)
+static _Thread_local Benchmark_Thread_Buffer *_benchmark_tls = NULL;
+static bool _benchmark_counters_enabled = false;
+
+// Origem da calibração: TSC e CLOCK_MONOTONIC lidos juntos no primeiro registro
+static uint64_t _benchmark_tsc_origin = 0;
+static uint64_t _benchmark_ns_origin = 0;
 
 // Helper para pegar o tempo atual em nanosegundos (monotônico)
 static inline uint64_t benchmark_get_nanos() {
@@ -23,17 +104,194 @@ static inline uint64_t benchmark_get_nanos() {
     return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
 }
 
-// Registra uma nova função na lista encadeada (Executado apenas 1x por função)
+// Relógio das amostras: TSC (sem serialização, ~20 ciclos) ou ns como fallback
+static inline uint64_t benchmark_ticks() {
+#if BENCHMARK_HAS_TSC
+    return __rdtsc();
+#else
+    return benchmark_get_nanos();
+#endif
+}
+
+static inline uint32_t benchmark_bucket_index(uint64_t ticks) {
+    if (ticks < BENCHMARK_SUB_BUCKETS) return (uint32_t)ticks;
+
+    uint32_t magnitude = 63 - __builtin_clzll(ticks);
+    if (magnitude >= BENCHMARK_MAX_MAGNITUDE) return BENCHMARK_BUCKETS - 1;
+
+    uint32_t shift = magnitude - BENCHMARK_SUB_BUCKET_BITS;
+    return (shift + 1) * BENCHMARK_SUB_BUCKETS + (uint32_t)((ticks >> shift) & (BENCHMARK_SUB_BUCKETS - 1));
+}
+
+// Valor representativo (meio) do bucket
+static inline uint64_t benchmark_bucket_value(uint32_t index) {
+    if (index < BENCHMARK_SUB_BUCKETS) return index;
+
+    uint32_t shift = index / BENCHMARK_SUB_BUCKETS - 1;
+    uint64_t sub = index % BENCHMARK_SUB_BUCKETS + BENCHMARK_SUB_BUCKETS;
+    return (sub << shift) + ((1ULL << shift) >> 1);
+}
+
+// Registra um ponto de medição (Executado apenas 1x por ponto, em qualquer thread)
 static inline void benchmark_register(Function_Profile *p, const char *func_name) {
-    p->func_name = func_name;
-    p->total_ns = 0;
-    p->func_calls = 0;
-    
-    // Inserção na cabeça da lista (LIFO)
-    // 1. O próximo do novo nó aponta para a cabeça atual
-    p->next = _global_benchmark;
-    // 2. A cabeça global passa a ser o novo nó
-    _global_benchmark = p; 
+    pthread_mutex_lock(&_benchmark_lock);
+
+    if (p->index == 0) {
+        if (_benchmark_site_count == 0) {
+            _benchmark_ns_origin = benchmark_get_nanos();
+            _benchmark_tsc_origin = benchmark_ticks();
+        }
+
+        p->func_name = func_name;
+        if (_benchmark_site_count < BENCHMARK_MAX_SITES) {
+            _benchmark_sites[_benchmark_site_count++] = p;
+            __atomic_store_n(&p->index, _benchmark_site_count, __ATOMIC_RELEASE);
+        } else {
+            fprintf(stderr, "Warning: BENCHMARK_MAX_SITES reached, '%s' will not be profiled\n", func_name);
+            __atomic_store_n(&p->index, -1, __ATOMIC_RELEASE);
+        }
+    }
+
+    pthread_mutex_unlock(&_benchmark_lock);
+}
+
+static inline Benchmark_Thread_Buffer *benchmark_thread_buffer() {
+    Benchmark_Thread_Buffer *buffer = _benchmark_tls;
+    if (buffer != NULL) return buffer;
+
+    buffer = (Benchmark_Thread_Buffer*)calloc(1, sizeof(Benchmark_Thread_Buffer));
+    if (buffer == NULL) return NULL;
+
+    pthread_mutex_lock(&_benchmark_lock);
+    buffer->next = _benchmark_threads;
+    _benchmark_threads = buffer;
+    pthread_mutex_unlock(&_benchmark_lock);
+
+    _benchmark_tls = buffer;
+    return buffer;
+}
+
+static inline Benchmark_Histogram *benchmark_thread_histogram(int site) {
+    Benchmark_Thread_Buffer *buffer = benchmark_thread_buffer();
+    if (buffer == NULL) return NULL;
+
+    if (buffer->sites[site] == NULL) {
+        buffer->sites[site] = (Benchmark_Histogram*)calloc(1, sizeof(Benchmark_Histogram));
+    }
+
+    return buffer->sites[site];
+}
+
+// --- Contadores de hardware ---
+
+#if BENCHMARK_HAS_PERF
+static inline void benchmark_counter_config(Benchmark_Counter counter, struct perf_event_attr *attr) {
+    uint64_t read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    switch (counter) {
+        case BENCHMARK_CYCLES:        attr->type = PERF_TYPE_HARDWARE; attr->config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case BENCHMARK_INSTRUCTIONS:  attr->type = PERF_TYPE_HARDWARE; attr->config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case BENCHMARK_L1D_MISSES:    attr->type = PERF_TYPE_HW_CACHE; attr->config = PERF_COUNT_HW_CACHE_L1D | read_miss; break;
+        case BENCHMARK_LLC_MISSES:    attr->type = PERF_TYPE_HARDWARE; attr->config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case BENCHMARK_DTLB_MISSES:   attr->type = PERF_TYPE_HW_CACHE; attr->config = PERF_COUNT_HW_CACHE_DTLB | read_miss; break;
+        default:                      attr->type = PERF_TYPE_HARDWARE; attr->config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    }
+}
+
+static inline int benchmark_perf_open(Benchmark_Counter counter, int group_fd) {
+    struct perf_event_attr attr = {0};
+    attr.size = sizeof(attr);
+    benchmark_counter_config(counter, &attr);
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // pid = 0, cpu = -1: só a thread atual, em qualquer CPU
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+// Abre o grupo da thread: sem o líder (ciclos) não há contadores; os demais entram se o hardware tiver
+static inline bool benchmark_counters_open(Benchmark_Thread_Buffer *buffer) {
+    if (buffer->perf_state != 0) return buffer->perf_state > 0;
+    buffer->perf_state = -1;
+
+#if BENCHMARK_HAS_PERF
+    buffer->perf_leader = benchmark_perf_open(BENCHMARK_CYCLES, -1);
+    if (buffer->perf_leader < 0) return false;
+
+    int slot = 0;
+    buffer->perf_slots[BENCHMARK_CYCLES] = slot++;
+    for (int counter = 1; counter < BENCHMARK_COUNTER_COUNT; counter++) {
+        int fd = benchmark_perf_open((Benchmark_Counter)counter, buffer->perf_leader);
+        buffer->perf_slots[counter] = (fd >= 0) ? slot++ : -1;
+    }
+
+    buffer->perf_state = 1;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static inline void benchmark_counters_read(Benchmark_Counter_Values *out) {
+    out->valid = false;
+    if (!__atomic_load_n(&_benchmark_counters_enabled, __ATOMIC_RELAXED)) return;
+
+#if BENCHMARK_HAS_PERF
+    Benchmark_Thread_Buffer *buffer = benchmark_thread_buffer();
+    if (buffer == NULL || !benchmark_counters_open(buffer)) return;
+
+    // PERF_FORMAT_GROUP: { nr, valores[nr] } em um único read()
+    uint64_t raw[1 + BENCHMARK_COUNTER_COUNT];
+    if (read(buffer->perf_leader, raw, sizeof(raw)) <= 0) return;
+
+    for (int counter = 0; counter < BENCHMARK_COUNTER_COUNT; counter++) {
+        int slot = buffer->perf_slots[counter];
+        out->values[counter] = (slot >= 0) ? raw[1 + slot] : 0;
+    }
+    out->valid = true;
+#endif
+}
+
+/*
+Liga a coleta de contadores em todos os pontos. Testa a abertura na thread atual:
+retorna false (e segue só com tempo) se perf_event_open não estiver disponível.
+ */
+static inline bool benchmark_enable_counters() {
+    Benchmark_Thread_Buffer *buffer = benchmark_thread_buffer();
+    if (buffer == NULL || !benchmark_counters_open(buffer)) {
+        fprintf(stderr, "Warning: perf_event_open unavailable, benchmark will report timing only\n");
+        return false;
+    }
+
+    __atomic_store_n(&_benchmark_counters_enabled, true, __ATOMIC_RELAXED);
+    return true;
+}
+
+static inline void benchmark_record(Function_Profile *p, uint64_t ticks, const Benchmark_Counter_Values *start) {
+    // Contadores lidos antes de qualquer trabalho do próprio profiler
+    Benchmark_Counter_Values end;
+    end.valid = false;
+    if (start->valid) benchmark_counters_read(&end);
+
+    int index = __atomic_load_n(&p->index, __ATOMIC_ACQUIRE);
+    if (index <= 0) return;
+
+    Benchmark_Histogram *hist = benchmark_thread_histogram(index - 1);
+    if (hist == NULL) return;
+
+    hist->count++;
+    hist->total_ticks += ticks;
+    if (ticks > hist->max_ticks) hist->max_ticks = ticks;
+    hist->buckets[benchmark_bucket_index(ticks)]++;
+
+    if (end.valid) {
+        hist->counter_samples++;
+        for (int counter = 0; counter < BENCHMARK_COUNTER_COUNT; counter++) {
+            hist->counters[counter] += end.values[counter] - start->values[counter];
+        }
+    }
 }
 
 // --- Macros de Controle ---
@@ -41,52 +299,197 @@ static inline void benchmark_register(Function_Profile *p, const char *func_name
 // Inicia o cronômetro (com nome personalizado)
 #define BENCHMARK_START_NAME(NAME_STR) \
     static Function_Profile _profile_data = {0}; \
-    static int _profile_initialized = 0; \
-    if (!_profile_initialized) { \
+    if (__atomic_load_n(&_profile_data.index, __ATOMIC_ACQUIRE) == 0) { \
         benchmark_register(&_profile_data, NAME_STR); \
-        _profile_initialized = 1; \
     } \
-    uint64_t _start_ns = benchmark_get_nanos(); // Variável LOCAL na stack
+    Benchmark_Counter_Values _start_counters = {0}; /* Zerado fora da janela medida: leituras que falham não deixam lixo */ \
+    benchmark_counters_read(&_start_counters); \
+    uint64_t _start_ticks = benchmark_ticks(); // Variáveis LOCAIS na stack
 
 // Atalho para usar o nome da própria função
 #define BENCHMARK_START() BENCHMARK_START_NAME(__func__)
 
-// Para o cronômetro e acumula os resultados
+// Para o cronômetro e grava a amostra no buffer da thread (o tempo não inclui a leitura dos contadores)
 #define BENCHMARK_END() \
-    uint64_t _end_ns = benchmark_get_nanos(); \
-    _profile_data.total_ns += (_end_ns - _start_ns); \
-    _profile_data.func_calls++;
+    benchmark_record(&_profile_data, benchmark_ticks() - _start_ticks, &_start_counters);
 
-// --- Função de Relatório (Output Formatado) ---
+// --- Calibração ---
+
+// ns por tick. Garante ao menos BENCHMARK_CALIBRATION_NS entre a origem e a leitura final.
+static inline double benchmark_ns_per_tick() {
+#if BENCHMARK_HAS_TSC
+    if (_benchmark_ns_origin == 0) {
+        _benchmark_ns_origin = benchmark_get_nanos();
+        _benchmark_tsc_origin = benchmark_ticks();
+    }
+
+    uint64_t now_ns = benchmark_get_nanos();
+    while (now_ns - _benchmark_ns_origin < BENCHMARK_CALIBRATION_NS) {
+        now_ns = benchmark_get_nanos();
+    }
+    uint64_t now_tsc = benchmark_ticks();
+
+    return (double)(now_ns - _benchmark_ns_origin) / (double)(now_tsc - _benchmark_tsc_origin);
+#else
+    return 1.0;
+#endif
+}
+
+// Custo mínimo de um START/END vazio, em ticks (o que toda amostra carrega a mais)
+static inline uint64_t benchmark_self_overhead_ticks() {
+    uint64_t best = UINT64_MAX;
+
+    for (int i = 0; i < 10000; i++) {
+        uint64_t start = benchmark_ticks();
+        uint64_t elapsed = benchmark_ticks() - start;
+        if (elapsed < best) best = elapsed;
+    }
+
+    return best;
+}
+
+// Menor delta de cada contador em um START/END vazio (o que toda amostra com contadores carrega a mais)
+static inline void benchmark_self_overhead_counters(Benchmark_Counter_Values *out) {
+    out->valid = false;
+
+    for (int i = 0; i < 100; i++) {
+        Benchmark_Counter_Values start, end;
+        benchmark_counters_read(&start);
+        benchmark_counters_read(&end);
+        if (!start.valid || !end.valid) return;
+
+        for (int counter = 0; counter < BENCHMARK_COUNTER_COUNT; counter++) {
+            uint64_t delta = end.values[counter] - start.values[counter];
+            if (!out->valid || delta < out->values[counter]) out->values[counter] = delta;
+        }
+        out->valid = true;
+    }
+}
+
+// Média por chamada do contador, já sem o overhead
+static inline double benchmark_counter_per_call(const Benchmark_Histogram *hist, Benchmark_Counter counter,
+                                                const Benchmark_Counter_Values *overhead) {
+    uint64_t total = hist->counters[counter];
+    uint64_t total_overhead = overhead->valid ? overhead->values[counter] * hist->counter_samples : 0;
+
+    total = (total > total_overhead) ? total - total_overhead : 0;
+    return (double)total / (double)hist->counter_samples;
+}
+
+// Percentil 'q' (0..1) do histograma, em ticks, já sem o overhead
+static inline uint64_t benchmark_percentile(const Benchmark_Histogram *hist, double q, uint64_t overhead) {
+    uint64_t target = (uint64_t)(q * (double)hist->count);
+    if (target >= hist->count) target = hist->count - 1;
 
-static void benchmark_print_stats() {
-    printf("\n============================================================================================\n");
-    printf("| %-20s | %-10s | %-15s | %-10s | %-15s |\n", 
-           "Função", "Chamadas", "Média (ns)", "Total (s)", "Total (ns)");
-    printf("============================================================================================\n");
-    
-    Function_Profile* current = _global_benchmark;
-    while (current != NULL) {
-        double media = 0;
-        if (current->func_calls > 0) {
-            media = (double)current->total_ns / current->func_calls;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BENCHMARK_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen > target) {
+            uint64_t value = benchmark_bucket_value(i);
+            if (value > hist->max_ticks) value = hist->max_ticks; // Bucket mais largo que a amostra máxima
+            return (value > overhead) ? value - overhead : 0;
         }
+    }
+
+    return 0;
+}
+
+// Soma os buffers de todas as threads para o ponto 'site'
+static inline void benchmark_merge_site(int site, Benchmark_Histogram *out) {
+    *out = (Benchmark_Histogram){0};
 
-        // Separa Segundos e Nanossegundos para exibição
-        uint64_t total_seconds = current->total_ns / 1000000000ULL;
-        uint64_t total_remainder_ns = current->total_ns % 1000000000ULL;
+    for (Benchmark_Thread_Buffer *buffer = _benchmark_threads; buffer != NULL; buffer = buffer->next) {
+        Benchmark_Histogram *hist = buffer->sites[site];
+        if (hist == NULL) continue;
 
-        printf("| %-20s | %-10lu | %-15.2f | %-10lu | %-15lu |\n", 
-               current->func_name,     // Nome
-               current->func_calls,    // Qtd Chamadas
-               media,                  // Média
-               total_seconds,          // Segundos inteiros
-               total_remainder_ns      // Nanossegundos restantes
-        );
-               
-        current = current->next;
+        out->count += hist->count;
+        out->total_ticks += hist->total_ticks;
+        if (hist->max_ticks > out->max_ticks) out->max_ticks = hist->max_ticks;
+        out->counter_samples += hist->counter_samples;
+        for (int counter = 0; counter < BENCHMARK_COUNTER_COUNT; counter++) {
+            out->counters[counter] += hist->counters[counter];
+        }
+        for (uint32_t i = 0; i < BENCHMARK_BUCKETS; i++) {
+            out->buckets[i] += hist->buckets[i];
+        }
     }
-    printf("============================================================================================\n");
 }
 
-#endif
\ No newline at end of file
+// --- Função de Relatório (Output Formatado) ---
+
+// Tabela dos contadores de hardware, por chamada ('merged' é só espaço de trabalho)
+static inline void benchmark_print_counters(Benchmark_Histogram *merged) {
+    Benchmark_Counter_Values overhead;
+    benchmark_self_overhead_counters(&overhead);
+
+    printf("\n===========================================================================================\n");
+    printf("| %-20s | %-8s | %-12s | %-12s | %-12s | %-12s |\n",
+           "Função", "IPC", "L1D miss", "LLC miss", "dTLB miss", "Branch miss");
+    printf("===========================================================================================\n");
+
+    pthread_mutex_lock(&_benchmark_lock);
+    for (int site = 0; site < _benchmark_site_count; site++) {
+        benchmark_merge_site(site, merged);
+        if (merged->counter_samples == 0) continue;
+
+        double cycles = benchmark_counter_per_call(merged, BENCHMARK_CYCLES, &overhead);
+        double instructions = benchmark_counter_per_call(merged, BENCHMARK_INSTRUCTIONS, &overhead);
+
+        printf("| %-20s | %-8.2f | %-12.3f | %-12.3f | %-12.3f | %-12.3f |\n",
+               _benchmark_sites[site]->func_name,
+               (cycles > 0) ? instructions / cycles : 0.0,
+               benchmark_counter_per_call(merged, BENCHMARK_L1D_MISSES, &overhead),
+               benchmark_counter_per_call(merged, BENCHMARK_LLC_MISSES, &overhead),
+               benchmark_counter_per_call(merged, BENCHMARK_DTLB_MISSES, &overhead),
+               benchmark_counter_per_call(merged, BENCHMARK_BRANCH_MISSES, &overhead));
+    }
+    pthread_mutex_unlock(&_benchmark_lock);
+
+    printf("===========================================================================================\n");
+    printf("Misses por chamada, overhead da leitura do grupo descontado\n");
+}
+
+static inline void benchmark_print_stats() {
+    double ns_per_tick = benchmark_ns_per_tick();
+    uint64_t overhead = benchmark_self_overhead_ticks();
+    Benchmark_Histogram *merged = (Benchmark_Histogram*)malloc(sizeof(Benchmark_Histogram));
+    if (merged == NULL) return;
+
+    printf("\n===========================================================================================================================\n");
+    printf("| %-20s | %-10s | %-12s | %-10s | %-10s | %-10s | %-12s | %-10s |\n",
+           "Função", "Chamadas", "Média (ns)", "p50 (ns)", "p99 (ns)", "p99.9 (ns)", "Max (ns)", "Total (s)");
+    printf("===========================================================================================================================\n");
+
+    pthread_mutex_lock(&_benchmark_lock);
+    for (int site = 0; site < _benchmark_site_count; site++) {
+        benchmark_merge_site(site, merged);
+        if (merged->count == 0) continue;
+
+        uint64_t total_overhead = overhead * merged->count;
+        uint64_t total_ticks = (merged->total_ticks > total_overhead) ? merged->total_ticks - total_overhead : 0;
+        uint64_t max_ticks = (merged->max_ticks > overhead) ? merged->max_ticks - overhead : 0;
+
+        printf("| %-20s | %-10lu | %-12.2f | %-10.0f | %-10.0f | %-10.0f | %-12.0f | %-10.4f |\n",
+               _benchmark_sites[site]->func_name,
+               merged->count,
+               (double)total_ticks * ns_per_tick / (double)merged->count,
+               (double)benchmark_percentile(merged, 0.50, overhead) * ns_per_tick,
+               (double)benchmark_percentile(merged, 0.99, overhead) * ns_per_tick,
+               (double)benchmark_percentile(merged, 0.999, overhead) * ns_per_tick,
+               (double)max_ticks * ns_per_tick,
+               (double)total_ticks * ns_per_tick / 1e9);
+    }
+    pthread_mutex_unlock(&_benchmark_lock);
+
+    printf("===========================================================================================================================\n");
+    printf("Overhead descontado: %.1f ns/amostra | %s: %.3f GHz\n",
+           (double)overhead * ns_per_tick, BENCHMARK_HAS_TSC ? "TSC" : "CLOCK_MONOTONIC", 1.0 / ns_per_tick);
+
+    if (__atomic_load_n(&_benchmark_counters_enabled, __ATOMIC_RELAXED)) {
+        benchmark_print_counters(merged);
+    }
+
+    free(merged);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+#include "backend_manager.h"
+#include "pool.h"
+
+#define FRAG_MAP_VERSION 1
+
+
+/*
+Análise de fragmentação: externa no backend (páginas livres presas em blocos pequenos), interna
+e de ocupação nas pools. As duas metades são lidas em momentos diferentes (locks separados), então
+com alocações concorrentes o relatório é uma aproximação.
+ */
+typedef struct Frag_Report {
+    Backend_Fragmentation backend;
+    Pool_Fragmentation pools;
+} Frag_Report;
+
+Frag_Report frag_analyze();
+void frag_print_report(FILE *out);
+
+/*
+Mapa por página das páginas já tiradas da reserva, para renderizar como heatmap. Formato texto:
+  linha 1: "pagemap <versão> page_size=<n> max_order=<n> pages=<n> huge_allocations=<n> huge_bytes=<n>"
+  depois uma linha por bloco de ordem máxima: "<página inicial> " + 2 caracteres por página
+    1º: dono ('.' livre, 'A' arena, 'P' pool, 'H' heap, 'D' debug, 'N' sem dono)
+    2º: ocupação de 0 (nada vivo) a 9 (cheia), pelos bytes dos blocos vivos nas páginas de chunks;
+        páginas livres são 0 e as demais páginas ocupadas, 9
+ */
+bool frag_export_page_map(FILE *out);
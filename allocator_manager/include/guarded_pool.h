@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+
+#define GUARDED_DEFAULT_SLOTS 256        // Blocos guardados vivos ou em quarentena ao mesmo tempo
+#define GUARDED_DEFAULT_SAMPLE_RATE 5000 // Em média, 1 a cada N palloc vai para a região guardada
+#define GUARDED_RECHECK_INTERVAL 65536   // Modo desligado: allocs entre duas consultas ao estado
+#define GUARDED_MAX_FRAMES 16
+
+
+/*
+Modo de amostragem com páginas de guarda (estilo GWP-ASan), para pegar use-after-free e overflow em produção.
+Cerca de 1 a cada 'sample_rate' palloc/pcalloc/palloc_hint (até uma página) vai para uma região própria:
+cada slot é uma página entre duas páginas PROT_NONE, com o bloco encostado no fim (overflow bate na
+guarda da direita). No free o slot volta a PROT_NONE e entra no fim de uma fila FIFO: só é reusado depois
+de todos os outros slots livres, então acessos tardios ainda falham.
+Um acesso inválido gera SIGSEGV: o handler imprime o tipo do erro e as pilhas de alocação e de free, e
+devolve o sinal ao handler anterior. Double free e free de ponteiro interno são relatados no próprio free (abort).
+As demais alocações pagam um decremento e um branch em TLS; os frees, uma subtração e um branch.
+ */
+bool guarded_pool_init(u32 max_slots, u32 sample_rate); // 0 = padrões
+
+typedef struct Guarded_Stats {
+    u64 allocs;
+    u64 frees;
+    u64 skipped;  // Amostras que seguiram pelo caminho normal (sem slot livre ou maiores que uma página)
+    u64 in_use;
+} Guarded_Stats;
+
+Guarded_Stats guarded_pool_get_stats();
+
+
+// ==========================
+//  GANCHOS (uso interno)
+// ==========================
+
+extern uintptr_t guarded_region_start;
+extern size_t guarded_region_size; // 0 com o modo desligado: guarded_owns() é sempre falso
+extern _Thread_local u32 guarded_countdown;
+
+void *guarded_alloc(size_t size); // NULL = segue pelo caminho normal (blocos saem zerados)
+void guarded_free(void *ptr);
+size_t guarded_usable_size(void *ptr);
+
+// Fim do intervalo da thread: tentar a região guardada
+static inline bool guarded_should_sample() {
+    return __builtin_expect(--guarded_countdown == 0, 0);
+}
+
+static inline bool guarded_owns(const void *ptr) {
+    return __builtin_expect((uintptr_t)ptr - guarded_region_start < guarded_region_size, 0);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+
+#define HEAP_PROFILER_DEFAULT_INTERVAL (512 * 1024) // Média de bytes alocados entre duas amostras
+#define HEAP_PROFILER_MAX_FRAMES 32
+
+
+/*
+Profiler de heap por amostragem. Cada thread conta os bytes alocados em palloc/pool_alloc/backend_alloc
+e, ao passar de um intervalo sorteado (distribuição exponencial com a média pedida, o que torna a
+amostragem de cada byte um processo de Poisson), guarda o backtrace do objeto até o free.
+O dump soma os objetos vivos por pilha, no formato "collapsed" (raiz;...;folha bytes) do flamegraph.pl.
+Cada amostra pesa size / (1 - e^(-size/média)) bytes: estimativa sem viés do total alocado naquela pilha.
+Desligado, o custo em cada ponto de entrada é um único branch previsível.
+ */
+bool heap_profiler_start(size_t mean_interval); // 0 = HEAP_PROFILER_DEFAULT_INTERVAL
+void heap_profiler_stop();
+bool heap_profiler_dump_collapsed(FILE *out);
+
+
+// ==========================
+//  GANCHOS (uso interno)
+// ==========================
+
+extern bool heap_profiler_enabled;
+extern _Thread_local i64 heap_profiler_bytes_left;
+
+void heap_profiler_sample(void *ptr, size_t size);
+void heap_profiler_forget(void *ptr);
+
+static inline bool heap_profiler_is_enabled() {
+    return __builtin_expect(__atomic_load_n(&heap_profiler_enabled, __ATOMIC_RELAXED), 0);
+}
+
+// Só com o profiler ligado: desconta a alocação do intervalo da thread
+static inline void heap_profiler_account(void *ptr, size_t size) {
+    heap_profiler_bytes_left -= (i64)size;
+    if (heap_profiler_bytes_left < 0) heap_profiler_sample(ptr, size);
+}
+
+static inline void heap_profiler_on_alloc(void *ptr, size_t size) {
+    if (heap_profiler_is_enabled()) heap_profiler_account(ptr, size);
+}
+
+static inline void heap_profiler_on_free(void *ptr) {
+    if (heap_profiler_is_enabled()) heap_profiler_forget(ptr);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <stddef.h>
+
+#include "utilities.h"
+
+/*
+Front-end único do alocador:
+  - size <= MAX_POOL_BLOCK_SIZE: pools genéricas (palloc), pequenas e médias
+  - até a ordem máxima do backend: blocos de páginas (OWNER_HEAP)
+  - acima disso: alocação huge (mmap próprio)
+mem_free descobre o dono pelo Page_Descriptor, não é preciso lembrar qual caminho alocou
+(OWNER_POOL -> pool_free; OWNER_HEAP e OWNER_ARENA -> backend_free).
+ */
+
+void *mem_alloc(size_t size);
+void *mem_calloc(size_t count, size_t size);
+void mem_free(void *ptr);
+void *mem_realloc(void *ptr, size_t new_size);
+size_t mem_usable_size(void *ptr);
@@ -0,0 +1,172 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MM_STATS_HAS_TSC 1
+#else
+#define MM_STATS_HAS_TSC 0
+#endif
+
+#include "utilities.h"
+#include "backend_manager.h"
+#include "pool.h"
+
+#define MM_STATS_MAX_SHARDS 128 // Threads simultâneas com shard próprio; as demais dividem um shard atômico
+#define MM_STATS_OWNER_COUNT (OWNER_DEBUG + 1)
+#define MM_STATS_CALIBRATION_NS 1000000ULL // Janela mínima para converter os ticks do TSC em ns (1 ms)
+
+// -DMM_SLOW_PATH_TIMING=0: os caminhos lentos só contam eventos, sem ler o relógio
+#ifndef MM_SLOW_PATH_TIMING
+#define MM_SLOW_PATH_TIMING 1
+#endif
+
+
+/*
+Estatísticas sempre ligadas do alocador. Cada thread incrementa o seu próprio shard (load/store
+relaxados, sem lock prefix); mm_stats_get() soma os shards sem lock, então quem lê não trava quem aloca.
+Shards de threads encerradas são reaproveitados sem zerar: os contadores nunca andam para trás.
+ */
+
+typedef struct Mm_Stats_Class {
+    size_t block_size;
+    u64 allocs;
+    u64 frees;
+    u64 requested_bytes; // Soma dos tamanhos pedidos ao palloc (acumulada): fragmentação interna da classe
+    u64 live_blocks;
+    u64 chunks; // Chunks na lista da classe (curta e longa), sem os das reservas
+} Mm_Stats_Class;
+
+typedef struct Mm_Stats_Owner {
+    u64 committed_pages; // Páginas entregues pelo backend a esse dono (reserva + huge)
+    u64 used_pages;      // Ocupadas por dados vivos: páginas pedidas ao backend (sem o arredondamento da ordem
+                         // nem o header huge); OWNER_POOL conta só os blocos vivos das classes
+} Mm_Stats_Owner;
+
+typedef struct Mm_Stats {
+    size_t page_size;
+    Mm_Stats_Class classes[MAX_GENERIC_POOLS];
+    Mm_Stats_Owner owners[MM_STATS_OWNER_COUNT];
+
+    u64 huge_bytes; // Vivos, incluindo a página de header
+    u64 huge_allocs;
+    u64 huge_frees;
+
+    u64 reserve_committed_pages; // Páginas da reserva já liberadas do PROT_NONE
+    u64 reserve_refills;         // Blocos de ordem máxima tirados da reserva
+    u64 purges;
+    u64 purged_pages;
+    u64 pool_refills;            // Chunks que as pools pediram ao backend (fora das reservas)
+} Mm_Stats;
+
+/*
+Caminhos lentos: quantas vezes o caminho rápido falhou e quanto custou cada falha.
+  POOL_REFILL:    pool sem bloco livre nos chunks da lista -> pool_get_memory() (reservas de chunks ou backend);
+                  trocar o chunk ativo por um da lista que já tem blocos livres não conta
+  RESERVE_COMMIT: nenhuma bin atende -> bloco de ordem máxima tirado da reserva (mprotect)
+  SPLIT:          alloc do backend que dividiu um bloco maior; depth soma os níveis divididos
+  MERGE:          free do backend que entrou no buddy (BINS: fusões do cache tardio); depth soma as fusões
+  HUGE_MMAP / HUGE_MUNMAP: alocações acima da ordem máxima
+Tempos aninhados: POOL_REFILL inclui o que o backend gastou; SPLIT não inclui o commit da reserva que o precedeu.
+ */
+typedef enum Mm_Slow_Path {
+    MM_SLOW_POOL_REFILL,
+    MM_SLOW_RESERVE_COMMIT,
+    MM_SLOW_SPLIT,
+    MM_SLOW_MERGE,
+    MM_SLOW_HUGE_MMAP,
+    MM_SLOW_HUGE_MUNMAP,
+    MM_SLOW_PATH_COUNT
+} Mm_Slow_Path;
+
+typedef struct Mm_Slow_Path_Stats {
+    u64 events;
+    u64 depth;
+    u64 total_ns;
+} Mm_Slow_Path_Stats;
+
+typedef struct Mm_Slow_Path_Snapshot {
+    Mm_Slow_Path_Stats paths[MM_SLOW_PATH_COUNT];
+    u64 elapsed_ns; // Desde o último mm_slow_path_reset() (ou o primeiro contador)
+} Mm_Slow_Path_Snapshot;
+
+Mm_Stats mm_stats_get();
+void mm_stats_dump_json(FILE *out);
+
+// O reset só guarda a soma atual como base: as threads continuam somando sem coordenação
+void mm_slow_path_reset();
+Mm_Slow_Path_Snapshot mm_slow_path_snapshot();
+const char *mm_slow_path_name(Mm_Slow_Path path);
+
+
+// ==========================
+//  CONTADORES (uso interno)
+// ==========================
+
+typedef struct Mm_Stats_Shard {
+    i64 class_allocs[MAX_GENERIC_POOLS];
+    i64 class_frees[MAX_GENERIC_POOLS];
+    i64 class_requested[MAX_GENERIC_POOLS];
+    i64 class_chunks[MAX_GENERIC_POOLS];
+    i64 owner_pages[MM_STATS_OWNER_COUNT];
+    i64 owner_used_pages[MM_STATS_OWNER_COUNT]; // Páginas pedidas (reserva: sem o arredondamento da ordem; huge: sem o header)
+    i64 huge_bytes;
+    i64 huge_allocs;
+    i64 huge_frees;
+    i64 reserve_pages;
+    i64 reserve_refills;
+    i64 purges;
+    i64 purged_pages;
+    i64 pool_refills;
+    i64 slow_events[MM_SLOW_PATH_COUNT];
+    i64 slow_depth[MM_SLOW_PATH_COUNT];
+    i64 slow_ticks[MM_SLOW_PATH_COUNT];
+    bool shared; // Shard de transbordo: incrementos atômicos
+} __attribute__((aligned(CACHE_LINE_SIZE))) Mm_Stats_Shard;
+
+extern _Thread_local Mm_Stats_Shard *mm_stats_tls;
+Mm_Stats_Shard *mm_stats_attach();
+
+static inline Mm_Stats_Shard *mm_stats_shard() {
+    Mm_Stats_Shard *shard = mm_stats_tls;
+    return __builtin_expect(shard != NULL, 1) ? shard : mm_stats_attach();
+}
+
+// 'counter' precisa estar em 'shard'
+static inline void mm_stats_add(Mm_Stats_Shard *shard, i64 *counter, i64 delta) {
+    if (__builtin_expect(shard->shared, 0)) {
+        __atomic_fetch_add(counter, delta, __ATOMIC_RELAXED);
+    } else {
+        __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+    }
+}
+
+#define MM_STATS_ADD(field, delta) do { \
+        Mm_Stats_Shard *_mm_shard = mm_stats_shard(); \
+        mm_stats_add(_mm_shard, &_mm_shard->field, (delta)); \
+    } while (0)
+
+// Relógio dos caminhos lentos: TSC (convertido no snapshot) ou ns como fallback
+static inline u64 mm_stats_ticks() {
+#if !MM_SLOW_PATH_TIMING
+    return 0;
+#elif MM_STATS_HAS_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static inline void mm_stats_slow_path(Mm_Slow_Path path, u64 depth, u64 start_ticks) {
+    u64 ticks = mm_stats_ticks() - start_ticks;
+    Mm_Stats_Shard *shard = mm_stats_shard();
+
+    mm_stats_add(shard, &shard->slow_events[path], 1);
+    if (depth > 0) mm_stats_add(shard, &shard->slow_depth[path], (i64)depth);
+    mm_stats_add(shard, &shard->slow_ticks[path], (i64)ticks);
+}
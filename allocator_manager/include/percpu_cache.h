@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+
+#define PERCPU_CACHE_SLOTS 32   // Blocos guardados por classe, por CPU
+#define PERCPU_CACHE_MAX_CLASSES 32
+
+
+/*
+Cache por CPU (modo per-CPU do tcmalloc) na frente das generic pools.
+push/pop rodam como seções críticas rseq: sem atomics e sem lock, o kernel reinicia a seção
+se a thread for preemptada ou migrar de CPU. Sem suporte a rseq, percpu_cache_init() falha
+e o chamador segue pelo caminho com lock.
+ */
+bool percpu_cache_init(u32 num_classes);
+bool percpu_cache_is_enabled();
+void *percpu_cache_pop(u32 size_class);
+bool percpu_cache_push(u32 size_class, void *ptr);
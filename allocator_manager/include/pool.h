@@ -6,19 +6,106 @@
 #include "../include/backend_manager.h"
 
 #define POOL_ALLOCATION_LIMIT 32
-#define MAX_GENERIC_POOLS 7
-#define MAX_CUSTOM_POOLS 32
+#define SMALL_GENERIC_POOLS 7 // Classes potência de 2: 8 ... 512
+#define MEDIUM_CLASSES_PER_DOUBLING 4 // Classes médias entre duas potências de 2: 640, 768, 896, 1K, 1.25K ...
+#define MAX_GENERIC_POOLS (SMALL_GENERIC_POOLS + 5 * MEDIUM_CLASSES_PER_DOUBLING) // Até 16 KB
 #define MAX_HEAP_SIZE 1024 * 1024 * 64
-#define MAX_POOL_BLOCK_SIZE 512
+#define MAX_SMALL_POOL_BLOCK_SIZE 512 // Limite das pools customizadas, Object Caches e do cache por CPU
+#define MAX_POOL_BLOCK_SIZE (16 * 1024) // Limite do palloc (classes médias)
+#define MEDIUM_MIN_BLOCKS_PER_CHUNK 4 // Menor quantidade de blocos médios em um chunk
+#define CUSTOM_POOL_INDEX_SIZE (MAX_SMALL_POOL_BLOCK_SIZE / 8 + 1) // Índice das pools customizadas por block_size
 #define CHUNK_USAGE_TRESHOLD 0.75
 #define TARGET_BLOCK_COUNT 128
+#define CACHE_LINE_SIZE 64
+#define MAX_ALLOCATOR_ARENAS 16
+#define POOL_EMPTY_CHUNK_RESERVE 1   // Chunks vazios mantidos por pool
+#define GLOBAL_EMPTY_CHUNK_RESERVE 2 // Chunks vazios mantidos por chunk_order na reserva global
+#define PINNED_CHUNK_USAGE_TRESHOLD 0.25 // Chunk não vazio abaixo desse uso está preso por poucos blocos
+#define POOL_OCCUPANCY_BUCKETS 10 // Faixas de uso dos chunks em pool_get_fragmentation() (décimos)
 
 
 typedef struct Pool Pool;
+typedef struct Pool Object_Cache;
+
+// Como uma thread é associada a uma arena (Allocator) na sua primeira alocação
+typedef enum Arena_Policy {
+    ARENA_ROUND_ROBIN,
+    ARENA_BY_CPU
+} Arena_Policy;
+
+// Tempo de vida esperado de um bloco (palloc_hint): cada um tem suas próprias pools genéricas
+typedef enum Pool_Lifetime {
+    LIFETIME_SHORT, // Buffers de requisição, temporários (mesmas pools do palloc)
+    LIFETIME_LONG,  // Entradas de cache, estruturas que sobrevivem a muitas requisições
+    LIFETIME_COUNT
+} Pool_Lifetime;
+
+typedef void (*Object_Ctor)(void *obj);
+typedef void (*Object_Dtor)(void *obj);
+
+// Contadores da reserva de chunks vazios (histerese)
+typedef struct Pool_Reserve_Stats {
+    u64 pool_reserve_hits;   // Refills atendidos pela reserva da própria pool (sem re-fatiar)
+    u64 global_reserve_hits; // Refills atendidos pela reserva global (re-fatiado, sem backend)
+    u64 backend_refills;     // Refills que chegaram ao backend
+    u64 chunks_retained;     // Chunks vazios que entraram em alguma reserva
+    u64 chunks_released;     // Chunks devolvidos ao backend
+} Pool_Reserve_Stats;
+
+// Ocupação das pools genéricas por tempo de vida
+typedef struct Pool_Lifetime_Stats {
+    u64 chunks[LIFETIME_COUNT];        // Chunks nas listas das pools
+    u64 live_blocks[LIFETIME_COUNT];
+    u64 pinned_chunks[LIFETIME_COUNT]; // Chunks não vazios com uso abaixo de PINNED_CHUNK_USAGE_TRESHOLD
+    u64 pinned_bytes[LIFETIME_COUNT];  // Bytes desses chunks que não voltam ao backend por causa de poucos blocos
+} Pool_Lifetime_Stats;
+
+// Fragmentação de uma classe do palloc (pools curta e longa de todas as arenas)
+typedef struct Pool_Class_Fragmentation {
+    size_t block_size;
+    u64 chunks;
+    u64 chunk_bytes;
+    u64 capacity;    // Blocos nos chunks
+    u64 live_blocks; // Inclui os blocos parados no cache por CPU
+    u64 occupancy[POOL_OCCUPANCY_BUCKETS]; // Chunks por faixa de live/capacity: [0, 10%) ... [90%, 100%]
+    double internal_fragmentation; // 1 - bytes pedidos / bytes dos blocos entregues, acumulado desde o início
+    double chunk_overhead;         // Fração dos chunks fora dos blocos (header, cor, sobra do fim)
+} Pool_Class_Fragmentation;
+
+typedef struct Pool_Fragmentation {
+    Pool_Class_Fragmentation classes[MAX_GENERIC_POOLS];
+    u64 reserved_chunks; // Chunks vazios nas reservas (das pools e global), ainda fora do backend
+    u64 reserved_bytes;
+} Pool_Fragmentation;
 
 
 Pool *pool_create(size_t block_size);
 void *pool_alloc(Pool *p);
 void *palloc(size_t size);
+void *palloc_hint(size_t size, Pool_Lifetime lifetime);
+void *pcalloc(size_t size);
+void *prealloc(void *ptr, size_t new_size);
 void pool_free(void *ptr);
-void pool_destroy(Pool *pool);
\ No newline at end of file
+size_t pool_usable_size(void *ptr);
+size_t pool_class_size(size_t size);
+size_t pool_min_chunk_size(); // Menor bloco do backend que serve todas as classes do palloc
+void pool_destroy(Pool *pool);
+
+void allocator_set_arena_count(u32 count);
+void allocator_set_arena_policy(Arena_Policy policy);
+int allocator_get_thread_arena();
+bool pool_enable_percpu_cache();
+
+void pool_set_chunk_reserve(Pool *pool, size_t max_empty_chunks);
+void pool_set_global_chunk_reserve(size_t max_empty_chunks);
+Pool_Reserve_Stats pool_get_reserve_stats();
+Pool_Lifetime_Stats pool_get_lifetime_stats();
+Pool_Fragmentation pool_get_fragmentation();
+void pool_get_page_usage(u32 *live_bytes, size_t max_pages);
+void pool_set_cache_coloring(bool enabled); // Afeta apenas chunks fatiados a partir da chamada
+
+// Object Cache (slab): ctor roda uma vez por fatiamento de chunk, dtor quando o chunk volta ao backend
+Object_Cache *object_cache_create(size_t size, Object_Ctor ctor, Object_Dtor dtor);
+void *object_cache_alloc(Object_Cache *cache);
+void object_cache_free(void *obj);
+void object_cache_destroy(Object_Cache *cache);
\ No newline at end of file
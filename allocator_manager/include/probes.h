@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+Pontos de rastreamento estáticos (USDT) nos caminhos lentos, para bpftrace/perf/SystemTap.
+Com <sys/sdt.h> disponível (pacote systemtap-sdt-dev, só headers, sem dependência em tempo de execução),
+cada probe vira um único nop e uma nota ELF (.note.stapsdt) que o tracer usa para se anexar.
+Sem o header, ou com -DMM_DISABLE_PROBES, as macros somem.
+
+Provider: allocator_manager. Argumentos: ordem, tamanho em bytes, Page_Owner (as pools somam o block_size).
+  reserve_commit(order, size, owner)       backend_request_memory(): bloco de ordem máxima saindo do PROT_NONE
+  buddy_split(order, size, owner)          metade direita (livre) de um split
+  buddy_merge(order, size, owner)          bloco resultante de uma fusão com o buddy
+  huge_mmap(order, size, owner)            alocação acima da ordem máxima (ordem = menor potência que cobre)
+  huge_munmap(order, size, owner)
+  pool_refill(order, size, owner, block)   chunk entrando em uma pool (reserva da pool, global ou backend)
+  pool_chunk_release(order, size, owner, block)  chunk vazio saindo da lista de uma pool
+
+Ex.: bpftrace -e 'usdt:./bin/app:allocator_manager:buddy_split { @splits[arg0] = count(); }'
+ */
+
+#if !defined(MM_DISABLE_PROBES) && defined(__has_include)
+#  if __has_include(<sys/sdt.h>)
+#    include <sys/sdt.h>
+#    define MM_PROBES_ENABLED 1
+#  endif
+#endif
+
+#ifdef MM_PROBES_ENABLED
+#  define MM_PROBE3(name, order, size, owner) \
+        STAP_PROBE3(allocator_manager, name, (unsigned)(order), (unsigned long)(size), (unsigned)(owner))
+#  define MM_PROBE4(name, order, size, owner, extra) \
+        STAP_PROBE4(allocator_manager, name, (unsigned)(order), (unsigned long)(size), (unsigned)(owner), (unsigned long)(extra))
+#else
+// sizeof: marca os argumentos como usados sem avaliá-los
+#  define MM_PROBE3(name, order, size, owner) \
+        do { (void)sizeof(order); (void)sizeof(size); (void)sizeof(owner); } while (0)
+#  define MM_PROBE4(name, order, size, owner, extra) \
+        do { (void)sizeof(order); (void)sizeof(size); (void)sizeof(owner); (void)sizeof(extra); } while (0)
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+
+#define TRACE_BLOCK_SIZE (64 * 1024)                 // Bloco do arquivo reservado por uma thread de cada vez
+#define TRACE_DEFAULT_MAX_SIZE ((size_t)1 << 30)     // Tamanho máximo do arquivo (esparso até o trace_stop)
+
+// Byte de operação: bits 0-2 = operação, bit 3 = zerado (calloc), bit 4 = vida longa, bits 5-7 = Page_Owner
+typedef enum Trace_Op {
+    TRACE_OP_PALLOC = 1,
+    TRACE_OP_POOL_FREE,
+    TRACE_OP_BACKEND_ALLOC,
+    TRACE_OP_BACKEND_FREE
+} Trace_Op;
+
+#define TRACE_OP_MASK 0x07
+#define TRACE_FLAG_ZEROED 0x08
+#define TRACE_FLAG_LONG_LIVED 0x10
+#define TRACE_OWNER_SHIFT 5
+
+// Evento já decodificado (replayer)
+typedef struct Trace_Event {
+    u64 timestamp; // ns desde o trace_start
+    u64 address;   // Identidade do objeto: o endereço é único enquanto o objeto está vivo
+    u64 size;      // Só nas alocações
+    u32 thread;
+    u8 op;
+} Trace_Event;
+
+
+/*
+Gravação de palloc/pool_free/backend_alloc/backend_free (o que o programa pediu, não os chunks
+que as pools pegam do backend por conta própria). Cada thread escreve em um bloco próprio do
+arquivo mapeado em memória, sem lock; um bloco cheio é trocado por outro com um fetch_add.
+Evento: byte de operação, varint do delta de tempo, varint zigzag do delta de endereço, varint do tamanho.
+trace_stop() deve ser chamado com as threads gravadas já paradas (o mapeamento é desfeito).
+ */
+bool trace_start(const char *path, size_t max_size); // max_size 0 = TRACE_DEFAULT_MAX_SIZE
+void trace_stop();
+void trace_record(u8 op, void *ptr, size_t size);
+
+extern bool trace_enabled;
+
+static inline bool trace_is_enabled() {
+    return __builtin_expect(__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED), 0);
+}
+
+// Leitura: todos os eventos do arquivo em ordem de tempo (NULL em erro). Liberar com trace_free_events()
+Trace_Event *trace_load(const char *path, size_t *count, u32 *threads);
+void trace_free_events(Trace_Event *events, size_t count);
@@ -15,6 +15,9 @@ typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
+typedef int16_t i16;
+typedef int64_t i64;
+
 typedef float f32;
 typedef double f64;
 
@@ -1,17 +1,26 @@
 #include <sys/mman.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "../include/backend_manager.h"
 #include "../include/utilities.h"
+#include "../include/trace.h"
+#include "../include/mm_stats.h"
+#include "../include/heap_profiler.h"
+#include "../include/probes.h"
 
 
 #define PAGE_FREE 0x01
 #define PAGE_MMAPED 0x02
 #define PAGE_HUGE_ALLOCATION 0x04
 #define PAGE_HEAD 0x08
+#define PAGE_CACHED 0x10 // Livre, mas parado no cache de coalescing tardio (fora das bins, não funde)
+#define PAGE_ZEROED 0x20 // Bloco livre ainda zerado pelo SO (commit da reserva ou purge), nunca entregue desde então
 
 
 // ==========================
@@ -37,14 +46,47 @@ typedef struct Page_Bin {
     Page_Descriptor *free_list;
 } Page_Bin;
 
+/*
+Bitmap por ordem, bit i = bloco i daquela ordem está livre (inteiro).
+'summary' indica quais palavras de 'words' podem ter bits livres.
+  - Engine BITMAP: é o próprio estado livre/ocupado; summary é só uma dica, revalidada na busca.
+  - Engine BINS: índice de quem está em cada Page_Bin (política PAGE_POLICY_ADDRESS_ORDERED); summary exato.
+ */
+typedef struct Bitmap_Level {
+    u64 *words;
+    u64 *summary;
+    size_t num_words;
+    size_t num_summary;
+} Bitmap_Level;
+
 typedef struct Backend_Page_Manager {
+    pthread_mutex_t lock; // Compartilhado por todas as arenas do front-end (engine BINS)
+    Backend_Engine engine;
+    Page_Policy policy;
+    size_t reserve_size;
+    size_t page_size;
+    u32 page_shift;
+    u32 max_order;
+    size_t max_block_size; // page_size << max_order
     void *memory_start;
     size_t total_pages;
     size_t used_pages;
     size_t page_offset_index;
 
     Page_Descriptor *page_map;
-    Page_Bin bins[MAX_BIN_ORDER+1];
+    Page_Bin bins[MAX_BIN_ORDER_LIMIT+1];
+    u32 nonempty_bins; // Bit k = bins[k] tem blocos (engine BINS)
+    Bitmap_Level levels[MAX_BIN_ORDER_LIMIT+1];
+
+    /*
+    Coalescing tardio (engine BINS): blocos recém liberados ficam em uma pilha pequena por ordem,
+    sem fundir com os buddies. Um alloc da mesma ordem reaproveita o bloco direto. A fusão só
+    acontece quando a pilha enche ou quando nenhuma bin consegue atender um pedido.
+     */
+    bool lazy_coalescing;
+    Page_Descriptor *lazy_cache[MAX_BIN_ORDER_LIMIT+1][LAZY_COALESCE_CACHE_SIZE];
+    u32 lazy_count[MAX_BIN_ORDER_LIMIT+1];
+    Backend_Coalesce_Stats coalesce_stats;
 
     // debug info
     Huge_Allocation_Metadata *huge_allocation_list;
@@ -62,6 +104,24 @@ void bin_push(Page_Bin *bin, Page_Descriptor *node);
 void bin_remove(Page_Bin *bin, Page_Descriptor *node);
 Page_Descriptor *bin_pop(Page_Bin *bin);
 bool is_huge_allocation(void *ptr);
+size_t bitmap_metadata_size(size_t total_pages, u32 max_order);
+void bitmap_init_levels(u8 *base, size_t total_pages);
+void *bitmap_alloc(u32 order, Page_Owner owner, bool *zeroed);
+void bitmap_free(Page_Descriptor *block);
+void backend_coalesce(Page_Descriptor *block, Page_Owner owner);
+Page_Descriptor *backend_lazy_cache_pop(u32 order);
+Page_Descriptor *backend_take_block(u32 order, Page_Owner owner);
+void backend_flush_lazy_cache(u32 order, u32 count);
+void backend_flush_all_lazy_caches();
+void backend_trace_free(void *ptr);
+size_t backend_scan_pages(Backend_Fragmentation *frag, u8 *owners, size_t max_pages);
+void backend_count_free_block(Backend_Fragmentation *frag, u8 *owners, size_t max_pages, size_t first_page, u32 order);
+
+Page_Descriptor *bin_index_first(u32 order);
+static inline void bitmap_publish(Bitmap_Level *level, size_t bit);
+static inline bool bitmap_try_claim(Bitmap_Level *level, size_t bit);
+static inline u32 huge_order(size_t num_pages);
+static inline void backend_account_requested(Page_Descriptor *block, Page_Owner owner, size_t aligned_size);
 
 Backend_Page_Manager *backend_manager;
 
@@ -69,26 +129,77 @@ Backend_Page_Manager *backend_manager;
 //  FUNÇÕES PRINCIPAIS
 // ==========================
 
-void backend_init(size_t total_memory_size) {
-    size_t total_pages = total_memory_size / PAGE_SIZE;
-    size_t metadata_size = sizeof(Backend_Page_Manager) + (sizeof(Page_Descriptor) * total_pages);
+Backend_Config backend_default_config() {
+    return (Backend_Config){
+        .reserve_size = RESERVED_MEMORY_REGION_SIZE,
+        .page_size = PAGE_SIZE,
+        .max_order = MAX_BIN_ORDER,
+        .engine = BACKEND_ENGINE_BINS,
+    };
+}
+
+/*
+Reserva a região do backend com a geometria de 'config' (NULL = backend_default_config()).
+Retorna false se a configuração é inválida para o sistema ou se a reserva falhou.
+ */
+bool backend_init(const Backend_Config *config) {
+    Backend_Config cfg = config ? *config : backend_default_config();
+    if (cfg.page_size == 0) cfg.page_size = PAGE_SIZE;
+
+    // mprotect/madvise trabalham em páginas do sistema: a página do backend precisa ser múltipla delas
+    size_t system_page_size = (size_t)sysconf(_SC_PAGESIZE);
+    if (!is_power_of_two(cfg.page_size) || cfg.page_size < system_page_size) {
+        fprintf(stderr, "Error: Backend page size %zu is not a power of 2 multiple of the system page size (%zu)\n",
+                cfg.page_size, system_page_size);
+        return false;
+    }
+
+    if (cfg.max_order > MAX_BIN_ORDER_LIMIT) {
+        fprintf(stderr, "Error: Backend max order %u exceeds MAX_BIN_ORDER_LIMIT (%d)\n", cfg.max_order, MAX_BIN_ORDER_LIMIT);
+        return false;
+    }
+
+    size_t total_pages = cfg.reserve_size / cfg.page_size;
+    size_t descriptors_size = sizeof(Page_Descriptor) * total_pages;
+    // Os bitmaps por ordem são usados pelos dois engines (estado livre no BITMAP, índice das bins no BINS)
+    size_t metadata_size = sizeof(Backend_Page_Manager) + descriptors_size + bitmap_metadata_size(total_pages, cfg.max_order);
+    size_t metadata_pages = (metadata_size + cfg.page_size - 1) / cfg.page_size;
+
+    if (total_pages < metadata_pages + ((size_t)1 << cfg.max_order)) {
+        fprintf(stderr, "Error: Backend reserve of %zu bytes cannot hold its metadata and one block of order %u\n",
+                cfg.reserve_size, cfg.max_order);
+        return false;
+    }
 
     // Reservar memória do SO
-    void *raw_mem = mmap(NULL, total_memory_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void *raw_mem = mmap(NULL, cfg.reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw_mem == MAP_FAILED) {
+        fprintf(stderr, "Error: Backend reserve mmap failed\n");
+        return false;
+    }
 
     // Alocar 'metadata_size' bytes da memória reservada
     mprotect(raw_mem, metadata_size, PROT_READ | PROT_WRITE);
 
-    size_t metadata_pages = (metadata_size + PAGE_SIZE - 1) / PAGE_SIZE;
     size_t available_pages = total_pages - metadata_pages;
 
     // Inicializar gerenciador de páginas
     backend_manager = (Backend_Page_Manager*)raw_mem;
+    backend_manager->reserve_size = cfg.reserve_size;
+    backend_manager->page_size = cfg.page_size;
+    backend_manager->page_shift = fast_log2((u32)cfg.page_size);
+    backend_manager->max_order = cfg.max_order;
+    backend_manager->max_block_size = cfg.page_size << cfg.max_order;
     backend_manager->total_pages = available_pages;
-    backend_manager->memory_start = (void*)((char*)raw_mem + (metadata_pages * PAGE_SIZE));
+    backend_manager->memory_start = (void*)((char*)raw_mem + (metadata_pages * cfg.page_size));
     backend_manager->page_map = (Page_Descriptor*)((char*)raw_mem + sizeof(Backend_Page_Manager));
     backend_manager->page_offset_index = 0;
     backend_manager->used_pages = 0;
+    backend_manager->engine = cfg.engine;
+    backend_manager->policy = PAGE_POLICY_ADDRESS_ORDERED;
+    backend_manager->lazy_coalescing = (cfg.engine == BACKEND_ENGINE_BINS);
+    backend_manager->coalesce_stats = (Backend_Coalesce_Stats){0};
+    pthread_mutex_init(&backend_manager->lock, NULL);
     
     // debug section start
     backend_manager->huge_allocation_list = NULL;
@@ -100,17 +211,34 @@ void backend_init(size_t total_memory_size) {
     }
 
     // Inicializar (NULL) as bins de áreas livres
-    for (size_t i = 0; i <= MAX_BIN_ORDER; i++) {
+    for (size_t i = 0; i <= cfg.max_order; i++) {
         backend_manager->bins[i].free_list = NULL;
+        backend_manager->lazy_count[i] = 0;
     }
+    backend_manager->nonempty_bins = 0;
+
+    u8 *bitmap_base = (u8*)backend_manager->page_map + descriptors_size;
+    bitmap_init_levels(bitmap_base, available_pages);
+
+    return true;
+}
+
+size_t backend_page_size() {
+    return backend_manager ? backend_manager->page_size : PAGE_SIZE;
+}
+
+u32 backend_max_order() {
+    return backend_manager ? backend_manager->max_order : MAX_BIN_ORDER;
 }
 
 /*
-Aloca memória virgem, da reserva, para a Bin de maior ordem 
+Aloca memória virgem, da reserva, para a Bin de maior ordem ('owner' só identifica quem pediu nos probes)
  */
-int backend_request_memory() {
-    size_t bin_size = 1 << MAX_BIN_ORDER;
-    size_t alloc_size = bin_size * PAGE_SIZE;
+int backend_request_memory(Page_Owner owner) {
+    u64 slow_start = mm_stats_ticks();
+    u32 max_order = backend_manager->max_order;
+    size_t bin_size = (size_t)1 << max_order;
+    size_t alloc_size = backend_manager->max_block_size;
 
     if (backend_manager->page_offset_index + bin_size > backend_manager->total_pages) {
         fprintf(stderr, "Error: Out Of Memory");
@@ -121,21 +249,29 @@ int backend_request_memory() {
     void *page_start = get_address(head);
     mprotect(page_start, alloc_size, PROT_READ | PROT_WRITE);
 
-    head->flags = PAGE_FREE | PAGE_MMAPED | PAGE_HEAD;
-    head->order = MAX_BIN_ORDER;
+    // Páginas recém liberadas do PROT_NONE: o kernel entrega zeradas
+    head->flags = PAGE_FREE | PAGE_MMAPED | PAGE_HEAD | PAGE_ZEROED;
+    head->order = max_order;
     // head->owner_id = OWNER_NONE;
     head->owner_id = OWNER_DEBUG;
 
-    bin_push(&backend_manager->bins[MAX_BIN_ORDER], head);
+    bin_push(&backend_manager->bins[max_order], head);
     backend_manager->page_offset_index += bin_size;
+    MM_PROBE3(reserve_commit, max_order, alloc_size, owner);
+    mm_stats_slow_path(MM_SLOW_RESERVE_COMMIT, 0, slow_start);
+
+    MM_STATS_ADD(reserve_pages, (i64)bin_size);
+    MM_STATS_ADD(reserve_refills, 1);
 
     return 1;
 }
 
 void *backend_alloc_huge(size_t size, Page_Owner owner) {
-    size_t num_pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
-    size_t total_size = (num_pages + 1) * PAGE_SIZE; // +1 Página para o header
+    size_t page_size = backend_manager->page_size;
+    size_t num_pages = (size + page_size - 1) / page_size;
+    size_t total_size = (num_pages + 1) * page_size; // +1 Página para o header
 
+    u64 slow_start = mm_stats_ticks();
     void *mem_ptr = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 
     if (mem_ptr == MAP_FAILED) {
@@ -148,7 +284,15 @@ void *backend_alloc_huge(size_t size, Page_Owner owner) {
     meta->magic_number = HUGE_MAGIC_NUMBER;
     meta->owner = owner;
 
+    MM_STATS_ADD(owner_pages[owner], (i64)(total_size / page_size));
+    MM_STATS_ADD(owner_used_pages[owner], (i64)num_pages);
+    MM_STATS_ADD(huge_bytes, (i64)total_size);
+    MM_STATS_ADD(huge_allocs, 1);
+    mm_stats_slow_path(MM_SLOW_HUGE_MMAP, 0, slow_start);
+    MM_PROBE3(huge_mmap, huge_order(num_pages), total_size, owner);
+
     // debug section start
+    pthread_mutex_lock(&backend_manager->lock);
     if (backend_manager->huge_allocation_list == NULL) {
         meta->next = NULL;
         meta->prev = NULL;
@@ -159,21 +303,29 @@ void *backend_alloc_huge(size_t size, Page_Owner owner) {
         meta->prev = NULL;
         backend_manager->huge_allocation_list = meta;
     }
+    pthread_mutex_unlock(&backend_manager->lock);
     // debug section end
 
-    return (u8*)mem_ptr + PAGE_SIZE;
+    return (u8*)mem_ptr + page_size;
 }
 
 
 void backend_free_huge_allocation(void *ptr) {
-    Huge_Allocation_Metadata *meta = (Huge_Allocation_Metadata*)((u8*)ptr - PAGE_SIZE);
+    Huge_Allocation_Metadata *meta = (Huge_Allocation_Metadata*)((u8*)ptr - backend_manager->page_size);
 
     if (meta->magic_number != HUGE_MAGIC_NUMBER) {
         fprintf(stderr, "Error: Invalid huge block free request");
         return;
     }
 
+    MM_STATS_ADD(owner_pages[meta->owner], -(i64)(meta->total_size / backend_manager->page_size));
+    MM_STATS_ADD(owner_used_pages[meta->owner], -(i64)(meta->total_size / backend_manager->page_size - 1));
+    MM_STATS_ADD(huge_bytes, -(i64)meta->total_size);
+    MM_STATS_ADD(huge_frees, 1);
+    MM_PROBE3(huge_munmap, huge_order((meta->total_size >> backend_manager->page_shift) - 1), meta->total_size, meta->owner);
+
     // debug section start
+    pthread_mutex_lock(&backend_manager->lock);
     if (backend_manager->huge_allocation_list == meta) {
         backend_manager->huge_allocation_list = meta->next;
         if (meta->next) {
@@ -188,69 +340,164 @@ void backend_free_huge_allocation(void *ptr) {
             meta->next->prev = meta->prev;
         }
     }
+    pthread_mutex_unlock(&backend_manager->lock);
     // debug section end
     
-
-    munmap(ptr, meta->total_size);
+    // O mapeamento começa no header, uma página antes de ptr
+    u64 slow_start = mm_stats_ticks();
+    munmap(meta, meta->total_size);
+    mm_stats_slow_path(MM_SLOW_HUGE_MUNMAP, 0, slow_start);
 }
 
 void *backend_alloc(size_t size, Page_Owner owner) {
+    void *ptr = backend_alloc_fresh(size, owner, NULL);
+
+    // Páginas das próprias pools (chunks, metadados) não entram na trace: o replay as recria via palloc
+    if (trace_is_enabled() && owner != OWNER_POOL) {
+        trace_record(TRACE_OP_BACKEND_ALLOC | (owner << TRACE_OWNER_SHIFT), ptr, size);
+    }
+    if (heap_profiler_is_enabled() && owner != OWNER_POOL) heap_profiler_account(ptr, size);
+
+    return ptr;
+}
+
+/*
+Igual a backend_alloc(); se 'zeroed' não for NULL, informa se o bloco entregue ainda está zerado pelo SO.
+ */
+void *backend_alloc_fresh(size_t size, Page_Owner owner, bool *zeroed) {
     if (backend_manager == NULL) {
         fprintf(stderr, "Error: Backend Manager not initialized [backend_init()]\n");
         return NULL;
     }
 
-    size_t aligned_size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    size_t page_size = backend_manager->page_size;
+    size_t aligned_size = (size + page_size - 1) & ~(page_size - 1);
 
-    if (aligned_size > MAX_DEFAULT_ALLOCATION_SIZE) {
+    if (aligned_size > backend_manager->max_block_size) {
+        if (zeroed) *zeroed = true; // mmap anônimo novo
         return backend_alloc_huge(aligned_size, owner);
     }
  
 
     int order = get_order(aligned_size);
 
-    assert((order >= 0 && order <= MAX_BIN_ORDER) && "Invalid target order");
-    u8 k = order;
+    assert((order >= 0 && (u32)order <= backend_manager->max_order) && "Invalid target order");
 
-    while (k <= MAX_BIN_ORDER) {
-        if (backend_manager->bins[k].free_list != NULL) break;
-        k++;
+    if (backend_manager->engine == BACKEND_ENGINE_BITMAP) {
+        void *ptr = bitmap_alloc(order, owner, zeroed);
+        if (ptr != NULL) backend_account_requested(get_descriptor(ptr), owner, aligned_size);
+        return ptr;
     }
 
-    if (k > MAX_BIN_ORDER) {
-        if (!backend_request_memory()) {
+    Page_Descriptor *block = NULL;
+
+    pthread_mutex_lock(&backend_manager->lock);
+
+    if (backend_manager->lazy_count[order] > 0) {
+        // Cache de coalescing tardio: mesma ordem, sem split
+        block = backend_lazy_cache_pop(order);
+        backend_manager->coalesce_stats.lazy_hits++;
+    } else {
+        block = backend_take_block(order, owner);
+        if (block == NULL) {
+            pthread_mutex_unlock(&backend_manager->lock);
             return NULL;
         }
-        k = MAX_BIN_ORDER;
+    }
+
+    if (zeroed) *zeroed = (block->flags & PAGE_ZEROED) != 0;
+
+    // A partir daqui o dono escreve no bloco: ele volta sujo no free
+    block->flags &= ~(PAGE_FREE | PAGE_CACHED | PAGE_ZEROED);
+    block->flags |= PAGE_HEAD;
+    block->owner_id = owner;
+
+    backend_set_zone(block, owner);
+    backend_manager->used_pages += (1 << block->order);
+    MM_STATS_ADD(owner_pages[owner], (i64)1 << block->order);
+    backend_account_requested(block, owner, aligned_size);
+
+    pthread_mutex_unlock(&backend_manager->lock);
+    return get_address(block);
+}
+
+/*
+Bloco de páginas zerado. O memset só acontece se o bloco já foi usado desde o último commit/purge.
+ */
+void *backend_calloc(size_t size, Page_Owner owner) {
+    bool zeroed = false;
+    void *ptr = backend_alloc_fresh(size, owner, &zeroed);
+
+    if (ptr != NULL && !zeroed) {
+        memset(ptr, 0, size);
+    }
+
+    if (trace_is_enabled() && owner != OWNER_POOL) {
+        trace_record(TRACE_OP_BACKEND_ALLOC | TRACE_FLAG_ZEROED | (owner << TRACE_OWNER_SHIFT), ptr, size);
+    }
+    if (heap_profiler_is_enabled() && owner != OWNER_POOL) heap_profiler_account(ptr, size);
+
+    return ptr;
+}
+
+/*
+Menor ordem >= 'order' com bin não vazia (um ctz na máscara de bins), ou -1.
+Chamado com o lock do backend.
+ */
+static inline int backend_find_bin(u32 order) {
+    u32 candidates = backend_manager->nonempty_bins & ~((1u << order) - 1);
+    return candidates ? __builtin_ctz(candidates) : -1;
+}
+
+/*
+Procura a menor bin não vazia de ordem >= 'order' e divide o bloco até a ordem pedida.
+Chamado com o lock do backend.
+ */
+Page_Descriptor *backend_take_block(u32 order, Page_Owner owner) {
+    int k = backend_find_bin(order);
+
+    // Nenhuma bin atende: funde tudo que está no cache antes de pedir memória nova à reserva
+    if (k < 0 && backend_manager->lazy_coalescing) {
+        backend_flush_all_lazy_caches();
+        k = backend_find_bin(order);
+    }
+
+    if (k < 0) {
+        if (!backend_request_memory(owner)) return NULL;
+        k = backend_manager->max_order;
     }
 
     Page_Descriptor *block = bin_pop(&backend_manager->bins[k]);
+    if ((u32)k == order) return block;
 
-    while (k > order) {
+    u64 slow_start = mm_stats_ticks();
+    u32 depth = (u32)k - order;
+
+    while ((u32)k > order) {
         k--;
+        backend_manager->coalesce_stats.splits++;
 
-        size_t half_size = 1 << k;
+        size_t half_size = (size_t)1 << k;
 
         Page_Descriptor *buddy = block + half_size;
 
-        buddy->flags = PAGE_FREE | PAGE_HEAD;
+        buddy->flags = PAGE_FREE | PAGE_HEAD | (block->flags & PAGE_ZEROED);
         buddy->order = k;
         buddy->owner_id = OWNER_NONE;
 
         bin_push(&backend_manager->bins[k], buddy);
         block->order = k;
+        MM_PROBE3(buddy_split, k, backend_manager->page_size << k, owner);
     }
 
-    block->flags &= ~PAGE_FREE;
-    block->flags |= PAGE_HEAD;
-    block->owner_id = owner;
-
-    backend_set_zone(block, owner);
-    backend_manager->used_pages += (1 << block->order);
-    return get_address(block);
+    mm_stats_slow_path(MM_SLOW_SPLIT, depth, slow_start);
+    return block;
 }
 
 void backend_free(void *ptr) {
+    if (trace_is_enabled()) backend_trace_free(ptr);
+    heap_profiler_on_free(ptr);
+
     if (is_huge_allocation(ptr)) {
         backend_free_huge_allocation(ptr);
         return;
@@ -258,24 +505,82 @@ void backend_free(void *ptr) {
 
     Page_Descriptor *block = get_descriptor(ptr);
 
+    if (backend_manager->engine == BACKEND_ENGINE_BITMAP) {
+        bitmap_free(block);
+        return;
+    }
+
+    pthread_mutex_lock(&backend_manager->lock);
+
     // Sanity Check: Double Free
-    if (block->flags & PAGE_FREE) {
+    if (block->flags & (PAGE_FREE | PAGE_CACHED)) {
         // fprintf(stderr, "Double Free!\n");
+        pthread_mutex_unlock(&backend_manager->lock);
         return;
     }
 
     backend_manager->used_pages -= (1 << block->order);
+    Page_Owner owner = block->owner_id;
+    MM_STATS_ADD(owner_pages[owner], -((i64)1 << block->order));
+    MM_STATS_ADD(owner_used_pages[owner], -(i64)block->requested_pages);
+    block->owner_id = OWNER_NONE;
+
+    u32 order = block->order;
+
+    // Coalescing tardio: o bloco fica no cache da sua ordem, sem fundir (ordem máxima não tem com quem fundir)
+    if (backend_manager->lazy_coalescing && order < backend_manager->max_order) {
+        if (backend_manager->lazy_count[order] == LAZY_COALESCE_CACHE_SIZE) {
+            // Cache cheio: funde a metade mais antiga
+            backend_flush_lazy_cache(order, LAZY_COALESCE_CACHE_SIZE / 2);
+        }
+
+        block->flags |= PAGE_CACHED | PAGE_HEAD;
+        backend_manager->lazy_cache[order][backend_manager->lazy_count[order]++] = block;
+        backend_manager->coalesce_stats.deferred_frees++;
+
+        pthread_mutex_unlock(&backend_manager->lock);
+        return;
+    }
 
+    backend_coalesce(block, owner);
+
+    pthread_mutex_unlock(&backend_manager->lock);
+}
+
+/*
+Bytes utilizáveis a partir de ptr: o bloco inteiro da ordem, ou as páginas de uma alocação huge (sem o header)
+ */
+size_t backend_usable_size(void *ptr) {
+    if (is_huge_allocation(ptr)) {
+        Huge_Allocation_Metadata *meta = (Huge_Allocation_Metadata*)((u8*)ptr - backend_manager->page_size);
+        return meta->total_size - backend_manager->page_size;
+    }
+
+    Page_Descriptor *block = get_descriptor(ptr);
+    return REQUEST_SIZE_FROM_ORDER(block->order);
+}
+
+/*
+Funde o bloco com seus buddies livres, subindo a cascata até onde der, e insere na bin final.
+Chamado com o lock do backend.
+ */
+/*
+'owner' é o dono que acabou de liberar o bloco (OWNER_NONE vindo do cache de coalescing tardio), só para os probes.
+ */
+void backend_coalesce(Page_Descriptor *block, Page_Owner owner) {
     // Marca o bloco atual como livre para começar a subir a cascata
+    block->flags &= ~PAGE_CACHED;
     block->flags |= PAGE_FREE;
     block->flags |= PAGE_HEAD; // Garante que é uma cabeça válida
     block->owner_id = OWNER_NONE;
 
-    int k = block->order;
+    u32 k = block->order;
+    u32 first_order = k;
+    u64 slow_start = mm_stats_ticks();
 
-    while (k < MAX_BIN_ORDER) {
+    while (k < backend_manager->max_order) {
         size_t index = block - backend_manager->page_map;
-        size_t buddy_index = index ^ (1 << k);
+        size_t buddy_index = index ^ ((size_t)1 << k);
 
         // 1. PROTEÇÃO DE BORDA (Faltava no seu snippet)
         if (buddy_index >= backend_manager->total_pages) break;
@@ -291,6 +596,9 @@ void backend_free(void *ptr) {
             // Remove o vizinho da lista para fundir
             bin_remove(&backend_manager->bins[k], buddy);
 
+            // O bloco fundido só continua zerado se as duas metades estavam
+            u8 zeroed = block->flags & buddy->flags & PAGE_ZEROED;
+
             if (buddy_index < index) {
                 block = buddy;
                 // O bloco da direita perde o status de HEAD e FREE pois foi engolido
@@ -306,7 +614,10 @@ void backend_free(void *ptr) {
 
             k++;
             block->order = k;
+            block->flags = (block->flags & ~PAGE_ZEROED) | zeroed;
             block->flags |= PAGE_HEAD; // Reafirma que o novo blocão é HEAD
+            backend_manager->coalesce_stats.merges++;
+            MM_PROBE3(buddy_merge, k, backend_manager->page_size << k, owner);
         } else {
             break; // Não dá pra fundir
         }
@@ -314,7 +625,178 @@ void backend_free(void *ptr) {
 
     // Insere o bloco final (agora maior) na lista
     bin_push(&backend_manager->bins[k], block);
-    // backend_manager
+    mm_stats_slow_path(MM_SLOW_MERGE, k - first_order, slow_start);
+}
+
+/*
+Funde os 'count' blocos mais antigos do cache da ordem. Chamado com o lock do backend.
+ */
+void backend_flush_lazy_cache(u32 order, u32 count) {
+    u32 cached = backend_manager->lazy_count[order];
+    if (count > cached) count = cached;
+
+    for (u32 i = 0; i < count; i++) {
+        backend_coalesce(backend_manager->lazy_cache[order][i], OWNER_NONE);
+    }
+
+    for (u32 i = count; i < cached; i++) {
+        backend_manager->lazy_cache[order][i - count] = backend_manager->lazy_cache[order][i];
+    }
+
+    backend_manager->lazy_count[order] = cached - count;
+    backend_manager->coalesce_stats.lazy_flushes++;
+}
+
+/*
+Na política por endereço (padrão), o bloco de menor endereço do cache; em PAGE_POLICY_LIFO, o último que entrou.
+ */
+Page_Descriptor *backend_lazy_cache_pop(u32 order) {
+    Page_Descriptor **cache = backend_manager->lazy_cache[order];
+    u32 last = --backend_manager->lazy_count[order];
+    u32 selected = last;
+
+    if (backend_manager->policy == PAGE_POLICY_ADDRESS_ORDERED) {
+        for (u32 i = 0; i < last; i++) {
+            if (cache[i] < cache[selected]) selected = i;
+        }
+    }
+
+    Page_Descriptor *block = cache[selected];
+    cache[selected] = cache[last];
+    return block;
+}
+
+void backend_flush_all_lazy_caches() {
+    for (u32 k = 0; k <= backend_manager->max_order; k++) {
+        if (backend_manager->lazy_count[k] > 0) {
+            backend_flush_lazy_cache(k, backend_manager->lazy_count[k]);
+        }
+    }
+}
+
+/*
+Liga/desliga o coalescing tardio (engine BINS). Ao desligar, tudo que estava no cache é fundido.
+ */
+void backend_set_lazy_coalescing(bool enabled) {
+    if (backend_manager == NULL || backend_manager->engine != BACKEND_ENGINE_BINS) return;
+
+    pthread_mutex_lock(&backend_manager->lock);
+    if (!enabled) backend_flush_all_lazy_caches();
+    backend_manager->lazy_coalescing = enabled;
+    pthread_mutex_unlock(&backend_manager->lock);
+}
+
+void backend_set_page_policy(Page_Policy policy) {
+    if (backend_manager == NULL) return;
+
+    pthread_mutex_lock(&backend_manager->lock);
+    backend_manager->policy = policy;
+    pthread_mutex_unlock(&backend_manager->lock);
+}
+
+/*
+Devolve ao SO (MADV_DONTNEED) a cauda da reserva: os blocos livres de ordem máxima do fim da parte já
+tirada do PROT_NONE, até o primeiro bloco com páginas em uso. Com a política por endereço as alocações
+se concentram no começo da reserva, então os buracos antes desse ponto são os próximos a serem reusados
+e ficam residentes. Blocos ainda zerados (commit ou purge anterior, nunca entregues desde então) são pulados.
+Os blocos continuam livres: o próximo acesso recebe páginas zeradas do kernel.
+Retorna a quantidade de bytes devolvidos nesta chamada.
+ */
+size_t backend_purge() {
+    if (backend_manager == NULL) return 0;
+
+    size_t purged = 0;
+    u32 max_order = backend_manager->max_order;
+    size_t block_size = backend_manager->max_block_size;
+
+    if (backend_manager->engine == BACKEND_ENGINE_BITMAP) {
+        // Sem lock global: reivindica cada bloco livre antes de devolver, e publica de novo depois
+        Bitmap_Level *level = &backend_manager->levels[max_order];
+        size_t num_blocks = __atomic_load_n(&backend_manager->page_offset_index, __ATOMIC_RELAXED) >> max_order;
+
+        /*
+        O descritor do começo do bloco de ordem máxima é o da metade esquerda de todo split
+        (bitmap_alloc fica com ela), então qualquer entrega de páginas do bloco limpa PAGE_ZEROED dele.
+         */
+        for (size_t i = num_blocks; i-- > 0;) {
+            if (!bitmap_try_claim(level, i)) break;
+
+            Page_Descriptor *head = &backend_manager->page_map[i << max_order];
+            if (!(head->flags & PAGE_ZEROED)) {
+                madvise(get_address(head), block_size, MADV_DONTNEED);
+                head->flags |= PAGE_ZEROED;
+                purged += block_size;
+            }
+            bitmap_publish(level, i);
+        }
+
+        MM_STATS_ADD(purges, 1);
+        MM_STATS_ADD(purged_pages, (i64)(purged >> backend_manager->page_shift));
+        return purged;
+    }
+
+    pthread_mutex_lock(&backend_manager->lock);
+    backend_flush_all_lazy_caches();
+
+    for (size_t index = backend_manager->page_offset_index; index > 0;) {
+        index -= (size_t)1 << max_order;
+        Page_Descriptor *head = &backend_manager->page_map[index];
+
+        bool free_block = (head->flags & PAGE_FREE) && (head->flags & PAGE_HEAD) && head->order == max_order;
+        if (!free_block) break;
+
+        if (!(head->flags & PAGE_ZEROED)) {
+            madvise(get_address(head), block_size, MADV_DONTNEED);
+            head->flags |= PAGE_ZEROED; // Próximo acesso recebe páginas zeradas do kernel
+            purged += block_size;
+        }
+    }
+    pthread_mutex_unlock(&backend_manager->lock);
+
+    MM_STATS_ADD(purges, 1);
+    MM_STATS_ADD(purged_pages, (i64)(purged >> backend_manager->page_shift));
+    return purged;
+}
+
+Backend_Coalesce_Stats backend_get_coalesce_stats() {
+    if (backend_manager == NULL) return (Backend_Coalesce_Stats){0};
+
+    pthread_mutex_lock(&backend_manager->lock);
+    Backend_Coalesce_Stats stats = backend_manager->coalesce_stats;
+    pthread_mutex_unlock(&backend_manager->lock);
+
+    return stats;
+}
+
+/*
+Fragmentação externa: blocos livres por ordem e quanto das páginas livres fica em blocos pequenos demais
+para cada ordem. No engine BITMAP os alocadores não param durante a leitura (resultado aproximado).
+ */
+Backend_Fragmentation backend_get_fragmentation() {
+    Backend_Fragmentation frag;
+    memset(&frag, 0, sizeof(frag));
+    if (backend_manager == NULL) return frag;
+
+    backend_scan_pages(&frag, NULL, 0);
+    return frag;
+}
+
+/*
+Dono de cada página já tirada da reserva (Page_Owner, ou BACKEND_PAGE_FREE), em ordem de endereço
+a partir do início da região. Preenche até 'max_pages' e retorna o total de páginas tiradas da reserva.
+ */
+size_t backend_get_page_map(u8 *owners, size_t max_pages) {
+    if (backend_manager == NULL || owners == NULL) return 0;
+
+    Backend_Fragmentation frag;
+    memset(&frag, 0, sizeof(frag));
+    return backend_scan_pages(&frag, owners, max_pages);
+}
+
+// Índice da página de 'ptr' no mapa do backend, ou SIZE_MAX fora da reserva (huge)
+size_t backend_page_index(void *ptr) {
+    if (backend_manager == NULL || is_huge_allocation(ptr)) return SIZE_MAX;
+    return (size_t)((u8*)ptr - (u8*)backend_manager->memory_start) >> backend_manager->page_shift;
 }
 
 void backend_set_zone(Page_Descriptor *head, Page_Owner owner) {
@@ -330,22 +812,265 @@ void backend_set_zone(Page_Descriptor *head, Page_Owner owner) {
 
         tail->owner_id = owner;
         tail->zone_header = zone_start_addr;
-        tail->flags &= ~(PAGE_FREE | PAGE_HEAD); 
+        tail->flags &= ~(PAGE_FREE | PAGE_HEAD | PAGE_ZEROED); 
         tail->order = head->order; 
     }
 }
 
+// ==========================
+//  ENGINE BITMAP (LOCK-FREE)
+// ==========================
+
+/*
+Alternativa às Page_Bins: o estado livre/ocupado de cada bloco fica em bitmaps por ordem,
+atualizados com operações atômicas. Não existe lock global:
+  - alloc: reivindica (CAS) o primeiro bit livre na menor ordem possível; split = setar o bit do buddy
+  - free: tenta reivindicar o bit do buddy; se conseguir, funde e sobe uma ordem; senão publica o próprio bit
+    e confere o buddy de novo (free concorrente dos dois buddies, ver bitmap_free)
+Os descritores do bloco só são escritos pela thread dona do bloco.
+ */
+
+static inline size_t bitmap_level_bits(size_t total_pages, u32 order) {
+    return total_pages >> order;
+}
+
+size_t bitmap_metadata_size(size_t total_pages, u32 max_order) {
+    size_t bytes = 0;
+
+    for (u32 k = 0; k <= max_order; k++) {
+        size_t num_words = (bitmap_level_bits(total_pages, k) + 63) / 64;
+        size_t num_summary = (num_words + 63) / 64;
+        bytes += (num_words + num_summary) * sizeof(u64);
+    }
+
+    return bytes + sizeof(u64); // Folga para alinhar a base
+}
+
+void bitmap_init_levels(u8 *base, size_t total_pages) {
+    u64 *curr = (u64*)align_ptr(base, sizeof(u64));
+
+    for (u32 k = 0; k <= backend_manager->max_order; k++) {
+        Bitmap_Level *level = &backend_manager->levels[k];
+
+        level->num_words = (bitmap_level_bits(total_pages, k) + 63) / 64;
+        level->num_summary = (level->num_words + 63) / 64;
+        level->words = curr;
+        curr += level->num_words;
+        level->summary = curr;
+        curr += level->num_summary;
+
+        for (size_t i = 0; i < level->num_words; i++) level->words[i] = 0;
+        for (size_t i = 0; i < level->num_summary; i++) level->summary[i] = 0;
+    }
+}
+
+static inline void bitmap_publish(Bitmap_Level *level, size_t bit) {
+    size_t word = bit / 64;
+
+    // Ordem importa: palavra primeiro, summary depois (ver bitmap_claim_first)
+    __atomic_fetch_or(&level->words[word], 1ULL << (bit % 64), __ATOMIC_RELEASE);
+    __atomic_fetch_or(&level->summary[word / 64], 1ULL << (word % 64), __ATOMIC_RELEASE);
+}
+
+static inline bool bitmap_try_claim(Bitmap_Level *level, size_t bit) {
+    u64 mask = 1ULL << (bit % 64);
+    u64 old = __atomic_fetch_and(&level->words[bit / 64], ~mask, __ATOMIC_ACQUIRE);
+    return (old & mask) != 0;
+}
+
+/*
+Reivindica o bit livre de menor índice (= menor endereço). Retorna -1 se a ordem está vazia.
+ */
+static i64 bitmap_claim_first(Bitmap_Level *level) {
+    for (size_t s = 0; s < level->num_summary; s++) {
+        u64 summary = __atomic_load_n(&level->summary[s], __ATOMIC_ACQUIRE);
+
+        while (summary != 0) {
+            size_t w = s * 64 + __builtin_ctzll(summary);
+            u64 word = __atomic_load_n(&level->words[w], __ATOMIC_ACQUIRE);
+
+            while (word != 0) {
+                u64 lowest = word & (~word + 1);
+                if (__atomic_compare_exchange_n(&level->words[w], &word, word & ~lowest, false,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                    return (i64)(w * 64 + __builtin_ctzll(lowest));
+                }
+                // CAS falhou: 'word' foi recarregado, tenta de novo
+            }
+
+            // Palavra vazia: apaga a dica e revalida, um publish concorrente pode ter chegado no meio
+            u64 summary_bit = 1ULL << (w % 64);
+            __atomic_fetch_and(&level->summary[s], ~summary_bit, __ATOMIC_ACQ_REL);
+            if (__atomic_load_n(&level->words[w], __ATOMIC_ACQUIRE) != 0) {
+                __atomic_fetch_or(&level->summary[s], summary_bit, __ATOMIC_RELEASE);
+            }
+
+            summary &= summary - 1;
+        }
+    }
+
+    return -1;
+}
+
+/*
+Equivalente lock-free de backend_request_memory(): reserva um bloco de ordem máxima virgem.
+O bloco já pertence à thread que chamou (não passa pelo bitmap).
+ */
+static i64 bitmap_request_memory(Page_Owner owner) {
+    u64 slow_start = mm_stats_ticks();
+    u32 max_order = backend_manager->max_order;
+    size_t bin_size = (size_t)1 << max_order;
+    size_t index = __atomic_fetch_add(&backend_manager->page_offset_index, bin_size, __ATOMIC_RELAXED);
+
+    if (index + bin_size > backend_manager->total_pages) {
+        fprintf(stderr, "Error: Out Of Memory");
+        return -1;
+    }
+
+    Page_Descriptor *head = &backend_manager->page_map[index];
+    mprotect(get_address(head), backend_manager->max_block_size, PROT_READ | PROT_WRITE);
+    head->flags = PAGE_MMAPED | PAGE_HEAD;
+
+    MM_STATS_ADD(reserve_pages, (i64)bin_size);
+    MM_STATS_ADD(reserve_refills, 1);
+    MM_PROBE3(reserve_commit, max_order, backend_manager->max_block_size, owner);
+    mm_stats_slow_path(MM_SLOW_RESERVE_COMMIT, 0, slow_start);
+
+    return (i64)(index >> max_order);
+}
+
+/*
+O engine BITMAP não guarda o estado zerado nos descritores (a fusão não os toca):
+só um bloco recém tirado da reserva é reportado como zerado.
+ */
+void *bitmap_alloc(u32 order, Page_Owner owner, bool *zeroed) {
+    u32 k = order;
+    i64 block_index = -1;
+    bool fresh = false;
+
+    while (k <= backend_manager->max_order) {
+        block_index = bitmap_claim_first(&backend_manager->levels[k]);
+        if (block_index >= 0) break;
+        k++;
+    }
+
+    if (block_index < 0) {
+        k = backend_manager->max_order;
+        block_index = bitmap_request_memory(owner);
+        if (block_index < 0) return NULL;
+        fresh = true;
+    }
+
+    // Split: a metade da esquerda continua nossa, a da direita é publicada como livre
+    u64 slow_start = (k > order) ? mm_stats_ticks() : 0;
+    u32 depth = k - order;
+
+    while (k > order) {
+        k--;
+        block_index <<= 1;
+        bitmap_publish(&backend_manager->levels[k], (size_t)block_index + 1);
+        MM_PROBE3(buddy_split, k, backend_manager->page_size << k, owner);
+    }
+    if (depth > 0) mm_stats_slow_path(MM_SLOW_SPLIT, depth, slow_start);
+
+    Page_Descriptor *block = &backend_manager->page_map[(size_t)block_index << order];
+    block->flags = (block->flags & PAGE_MMAPED) | PAGE_HEAD;
+    block->order = order;
+    block->owner_id = owner;
+
+    backend_set_zone(block, owner);
+    __atomic_fetch_add(&backend_manager->used_pages, (size_t)1 << order, __ATOMIC_RELAXED);
+    MM_STATS_ADD(owner_pages[owner], (i64)1 << order);
+    if (zeroed) *zeroed = fresh;
+    return get_address(block);
+}
+
+void bitmap_free(Page_Descriptor *block) {
+    // Sanity Check: Double Free
+    u8 old_flags = __atomic_fetch_or(&block->flags, PAGE_FREE, __ATOMIC_ACQ_REL);
+    if (old_flags & PAGE_FREE) return;
+
+    u32 k = block->order;
+    size_t block_index = (size_t)(block - backend_manager->page_map) >> k;
+
+    Page_Owner owner = block->owner_id;
+    MM_STATS_ADD(owner_pages[owner], -((i64)1 << k));
+    MM_STATS_ADD(owner_used_pages[owner], -(i64)block->requested_pages);
+    block->owner_id = OWNER_NONE;
+    __atomic_fetch_sub(&backend_manager->used_pages, (size_t)1 << k, __ATOMIC_RELAXED);
+
+    // Coalescing: só funde se conseguir tirar o buddy do bitmap (a reivindicação é atômica)
+    u32 first_order = k;
+    u64 slow_start = mm_stats_ticks();
+
+    for (;;) {
+        while (k < backend_manager->max_order) {
+            size_t buddy_index = block_index ^ 1;
+            if (!bitmap_try_claim(&backend_manager->levels[k], buddy_index)) break;
+
+            block_index >>= 1;
+            k++;
+            MM_PROBE3(buddy_merge, k, backend_manager->page_size << k, owner);
+        }
+
+        Page_Descriptor *head = &backend_manager->page_map[block_index << k];
+        head->flags |= PAGE_FREE | PAGE_HEAD;
+        head->order = k;
+
+        Bitmap_Level *level = &backend_manager->levels[k];
+        bitmap_publish(level, block_index);
+        if (k == backend_manager->max_order) break;
+
+        /*
+        Dois buddies liberados ao mesmo tempo podem falhar o claim um do outro e publicar os dois:
+        ninguém mais os fundiria (o alloc só divide). Depois do publish, se o buddy está livre, tenta de novo.
+        A metade da esquerda é sempre reivindicada primeiro: se as duas threads reconciliam, só uma ganha e segue.
+         */
+        size_t buddy_index = block_index ^ 1;
+        size_t left = block_index & ~(size_t)1;
+        u64 buddy_mask = 1ULL << (buddy_index % 64);
+
+        // Publish -> fence -> leitura nas duas threads: ao menos uma enxerga o bit da outra
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!(__atomic_load_n(&level->words[buddy_index / 64], __ATOMIC_ACQUIRE) & buddy_mask)) break;
+        if (!bitmap_try_claim(level, left)) break;
+        if (!bitmap_try_claim(level, left + 1)) {
+            // A metade da direita foi alocada: o free dela reconcilia
+            bitmap_publish(level, left);
+            break;
+        }
+
+        block_index = left >> 1;
+        k++;
+        MM_PROBE3(buddy_merge, k, backend_manager->page_size << k, owner);
+    }
+
+    mm_stats_slow_path(MM_SLOW_MERGE, k - first_order, slow_start);
+}
+
 // ==========================
 //  FUNÇÕES AUXILIARES
 // ==========================
 
 
 u32 get_num_pages_from_size(size_t size) {
-    size_t requested_pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t page_size = backend_page_size();
+    size_t requested_pages = (size + page_size - 1) / page_size;
     
     return round_up_pow2(requested_pages);
 }
 
+// Páginas pedidas (antes do arredondamento para a ordem): used_pages por dono no mm_stats_get()
+static inline void backend_account_requested(Page_Descriptor *block, Page_Owner owner, size_t aligned_size) {
+    block->requested_pages = (u16)(aligned_size >> backend_manager->page_shift);
+    MM_STATS_ADD(owner_used_pages[owner], (i64)block->requested_pages);
+}
+
+// Menor ordem que cobre uma alocação huge de 'num_pages' páginas (passa da ordem máxima)
+static inline u32 huge_order(size_t num_pages) {
+    return (num_pages > 1) ? 64 - __builtin_clzll(num_pages - 1) : 0;
+}
+
 u32 get_order(size_t size) {
     u32 num_pages = get_num_pages_from_size(size);
 
@@ -355,7 +1080,7 @@ u32 get_order(size_t size) {
 }
 
 Page_Descriptor *get_descriptor(void *ptr) {
-    u32 page_idx = ((char*)ptr - (char*)backend_manager->memory_start) / PAGE_SIZE;
+    size_t page_idx = (size_t)((char*)ptr - (char*)backend_manager->memory_start) >> backend_manager->page_shift;
     if (page_idx >= backend_manager->total_pages) {
         fprintf(stderr, "Error: Pointer out of bounds\n");
         return NULL;
@@ -364,11 +1089,55 @@ Page_Descriptor *get_descriptor(void *ptr) {
 }
 
 void *get_address(Page_Descriptor *node) {
-    u32 page_idx = node - backend_manager->page_map;
-    return (void*)((char*)backend_manager->memory_start + (page_idx * PAGE_SIZE));
+    size_t page_idx = node - backend_manager->page_map;
+    return (void*)((char*)backend_manager->memory_start + (page_idx << backend_manager->page_shift));
+}
+
+/*
+Índice das Page_Bins por endereço (engine BINS, chamado com o lock do backend).
+Bit (página >> ordem) do bitmap da ordem = bloco está na bin. O summary é mantido exato.
+ */
+static inline void bin_index_set(Page_Bin *bin, Page_Descriptor *node) {
+    u32 order = bin - backend_manager->bins;
+    Bitmap_Level *level = &backend_manager->levels[order];
+    size_t bit = (size_t)(node - backend_manager->page_map) >> order;
+    size_t word = bit / 64;
+
+    level->words[word] |= 1ULL << (bit % 64);
+    level->summary[word / 64] |= 1ULL << (word % 64);
+}
+
+static inline void bin_index_clear(Page_Bin *bin, Page_Descriptor *node) {
+    u32 order = bin - backend_manager->bins;
+    Bitmap_Level *level = &backend_manager->levels[order];
+    size_t bit = (size_t)(node - backend_manager->page_map) >> order;
+    size_t word = bit / 64;
+
+    level->words[word] &= ~(1ULL << (bit % 64));
+    if (level->words[word] == 0) {
+        level->summary[word / 64] &= ~(1ULL << (word % 64));
+    }
+}
+
+// Bloco de menor endereço da bin da ordem, ou NULL
+Page_Descriptor *bin_index_first(u32 order) {
+    Bitmap_Level *level = &backend_manager->levels[order];
+
+    for (size_t s = 0; s < level->num_summary; s++) {
+        if (level->summary[s] == 0) continue;
+
+        size_t word = s * 64 + __builtin_ctzll(level->summary[s]);
+        size_t bit = word * 64 + __builtin_ctzll(level->words[word]);
+        return &backend_manager->page_map[bit << order];
+    }
+
+    return NULL;
 }
 
 void bin_push(Page_Bin *bin, Page_Descriptor *node) {
+    bin_index_set(bin, node);
+    backend_manager->nonempty_bins |= 1u << (bin - backend_manager->bins);
+
     if (bin->free_list == NULL) {
         node->prev = NULL;
         node->next = NULL;
@@ -385,6 +1154,9 @@ void bin_push(Page_Bin *bin, Page_Descriptor *node) {
 }
 
 void bin_remove(Page_Bin *bin, Page_Descriptor *node) {
+    backend_manager->coalesce_stats.bin_removes++;
+    bin_index_clear(bin, node);
+
     if (node->prev != NULL) {
         node->prev->next = node->next;
     } else {
@@ -395,6 +1167,10 @@ void bin_remove(Page_Bin *bin, Page_Descriptor *node) {
         node->next->prev = node->prev;
     }
 
+    if (bin->free_list == NULL) {
+        backend_manager->nonempty_bins &= ~(1u << (bin - backend_manager->bins));
+    }
+
     node->prev = NULL;
     node->next = NULL;
 }
@@ -402,18 +1178,103 @@ void bin_remove(Page_Bin *bin, Page_Descriptor *node) {
 Page_Descriptor *bin_pop(Page_Bin *bin) {
     if (bin->free_list == NULL) return NULL;
 
+    // LIFO: o último liberado. Por endereço: o de menor endereço da ordem (compacta o uso no começo da reserva)
     Page_Descriptor *node = bin->free_list;
+    if (backend_manager->policy == PAGE_POLICY_ADDRESS_ORDERED) {
+        node = bin_index_first(bin - backend_manager->bins);
+    }
+
     bin_remove(bin, node);
     return node;
 }
 
 bool is_huge_allocation(void *ptr) {
     void *start = backend_manager->memory_start;
-    void *end = (u8*)start + (PAGE_SIZE * backend_manager->total_pages);  
+    void *end = (u8*)start + (backend_manager->total_pages << backend_manager->page_shift);
 
     return ((ptr >= start) && (ptr < end)) ? false : true;
 }
 
+// Grava o free na trace (antes de liberar), exceto páginas das pools
+void backend_trace_free(void *ptr) {
+    Page_Owner owner;
+
+    if (is_huge_allocation(ptr)) {
+        Huge_Allocation_Metadata *meta = (Huge_Allocation_Metadata*)((u8*)ptr - backend_manager->page_size);
+        if (meta->magic_number != HUGE_MAGIC_NUMBER) return;
+        owner = meta->owner;
+    } else {
+        owner = (Page_Owner)get_descriptor(ptr)->owner_id;
+    }
+
+    if (owner != OWNER_POOL) {
+        trace_record(TRACE_OP_BACKEND_FREE | (owner << TRACE_OWNER_SHIFT), ptr, 0);
+    }
+}
+
+/*
+Percorre as páginas já tiradas da reserva. Os bitmaps por ordem marcam os blocos livres nos dois engines
+(no BINS, o índice das bins); o cache de coalescing tardio fica fora deles. O lock também protege a lista huge.
+ */
+size_t backend_scan_pages(Backend_Fragmentation *frag, u8 *owners, size_t max_pages) {
+    pthread_mutex_lock(&backend_manager->lock);
+
+    size_t committed = __atomic_load_n(&backend_manager->page_offset_index, __ATOMIC_RELAXED);
+    if (committed > backend_manager->total_pages) committed = backend_manager->total_pages;
+    frag->committed_pages = committed;
+
+    if (owners != NULL) {
+        size_t limit = (committed < max_pages) ? committed : max_pages;
+        for (size_t i = 0; i < limit; i++) owners[i] = (u8)backend_manager->page_map[i].owner_id;
+    }
+
+    u32 max_order = backend_manager->max_order;
+    for (u32 k = 0; k <= max_order; k++) {
+        Bitmap_Level *level = &backend_manager->levels[k];
+
+        for (size_t w = 0; w < level->num_words; w++) {
+            u64 word = __atomic_load_n(&level->words[w], __ATOMIC_RELAXED);
+            while (word != 0) {
+                size_t block = w * 64 + __builtin_ctzll(word);
+                backend_count_free_block(frag, owners, max_pages, block << k, k);
+                word &= word - 1;
+            }
+        }
+
+        for (u32 i = 0; i < backend_manager->lazy_count[k]; i++) {
+            size_t first_page = backend_manager->lazy_cache[k][i] - backend_manager->page_map;
+            backend_count_free_block(frag, owners, max_pages, first_page, k);
+        }
+    }
+
+    for (Huge_Allocation_Metadata *meta = backend_manager->huge_allocation_list; meta != NULL; meta = meta->next) {
+        frag->huge_allocations++;
+        frag->huge_bytes += meta->total_size;
+    }
+
+    pthread_mutex_unlock(&backend_manager->lock);
+
+    // Páginas livres em blocos de ordem < k não servem um pedido de ordem k
+    size_t smaller = 0;
+    for (u32 k = 0; k <= max_order; k++) {
+        frag->unusable_free[k] = frag->free_pages ? (double)smaller / (double)frag->free_pages : 0.0;
+        smaller += frag->free_blocks[k] << k;
+    }
+    frag->external_fragmentation = frag->unusable_free[max_order];
+
+    return committed;
+}
+
+void backend_count_free_block(Backend_Fragmentation *frag, u8 *owners, size_t max_pages, size_t first_page, u32 order) {
+    size_t pages = (size_t)1 << order;
+
+    frag->free_blocks[order]++;
+    frag->free_pages += pages;
+
+    if (owners == NULL) return;
+    for (size_t i = first_page; i < first_page + pages && i < max_pages; i++) owners[i] = BACKEND_PAGE_FREE;
+}
+
 // ==========================
 //  FUNÇÕES DEBUG
 // ==========================
@@ -459,16 +1320,33 @@ void debug_print_bins() {
     size_t total_free_memory = 0;
 
     // Itera da maior ordem para a menor (visualização mais lógica)
-    for (int i = MAX_BIN_ORDER; i >= 0; i--) {
+    for (int i = backend_manager->max_order; i >= 0; i--) {
         Page_Bin *bin = &backend_manager->bins[i];
         
         // Calcula o tamanho do bloco nesta ordem
-        size_t block_size = (1 << i) * PAGE_SIZE;
+        size_t block_size = REQUEST_SIZE_FROM_ORDER(i);
         char size_str[16];
         debug_format_size(block_size, size_str);
 
         printf(" [%d]        | %-10s | ", i, size_str);
 
+        if (backend_manager->engine == BACKEND_ENGINE_BITMAP) {
+            // Sem listas: conta os bits livres da ordem
+            Bitmap_Level *level = &backend_manager->levels[i];
+            size_t free_blocks = 0;
+            for (size_t w = 0; w < level->num_words; w++) {
+                free_blocks += __builtin_popcountll(__atomic_load_n(&level->words[w], __ATOMIC_RELAXED));
+            }
+            printf("%zu free block(s) [bitmap]\n", free_blocks);
+            total_free_memory += free_blocks * block_size;
+            continue;
+        }
+
+        if (backend_manager->lazy_count[i] > 0) {
+            printf("(+%u cached) ", backend_manager->lazy_count[i]);
+            total_free_memory += backend_manager->lazy_count[i] * block_size;
+        }
+
         if (bin->free_list == NULL) {
             printf("(Empty)\n");
             continue;
@@ -532,10 +1410,14 @@ void debug_print_huge_allocation_list() {
 void debug_print_backend_manager_stats() {
     printf("\n======BACKEND MANAGER STATS======\n");
 
-    printf("Reserved Memory Capacity: %ld [%ld pages]\n", RESERVED_MEMORY_REGION_SIZE, (RESERVED_MEMORY_REGION_SIZE/PAGE_SIZE));
+    size_t reserve_size = backend_manager->reserve_size;
+    size_t page_size = backend_manager->page_size;
+
+    printf("Reserved Memory Capacity: %ld [%ld pages]\n", reserve_size, (reserve_size/page_size));
+    printf("Page Size: %ld | Max Order: %u [%ld bytes]\n", page_size, backend_manager->max_order, backend_manager->max_block_size);
     printf("Memory Start Address: %p\n", backend_manager->memory_start);
     printf("Total Pages: %ld\n", backend_manager->total_pages);
-    printf("Metadata Size: %ld [%ld pages]\n\n", (RESERVED_MEMORY_REGION_SIZE - (backend_manager->total_pages * PAGE_SIZE)), ((RESERVED_MEMORY_REGION_SIZE/PAGE_SIZE) - backend_manager->total_pages));
+    printf("Metadata Size: %ld [%ld pages]\n\n", (reserve_size - (backend_manager->total_pages * page_size)), ((reserve_size/page_size) - backend_manager->total_pages));
     debug_print_huge_allocation_list();
     debug_print_bins();
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "../include/fragmentation.h"
+
+
+// DECLARAÇÕES
+static char frag_owner_char(u8 owner);
+static void *frag_map_pages(size_t bytes);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+Frag_Report frag_analyze() {
+    Frag_Report report;
+    report.backend = backend_get_fragmentation();
+    report.pools = pool_get_fragmentation();
+    return report;
+}
+
+void frag_print_report(FILE *out) {
+    Frag_Report report = frag_analyze();
+    Backend_Fragmentation *backend = &report.backend;
+    u32 max_order = backend_max_order();
+    size_t page_size = backend_page_size();
+
+    fprintf(out, "=== BACKEND (external fragmentation) ===\n");
+    fprintf(out, "Committed pages: %zu | Free pages: %zu | Huge: %zu allocation(s), %zu bytes\n",
+            backend->committed_pages, backend->free_pages, backend->huge_allocations, backend->huge_bytes);
+    fprintf(out, " %-6s | %-11s | %-11s | %s\n", "ORDER", "BLOCK SIZE", "FREE BLOCKS", "FREE PAGES UNUSABLE AT THIS ORDER");
+    for (u32 k = 0; k <= max_order; k++) {
+        fprintf(out, " %-6u | %-11zu | %-11zu | %.1f%%\n",
+                k, page_size << k, backend->free_blocks[k], backend->unusable_free[k] * 100.0);
+    }
+    fprintf(out, "External fragmentation (free pages outside max-order blocks): %.1f%%\n\n",
+            backend->external_fragmentation * 100.0);
+
+    fprintf(out, "=== POOLS (internal fragmentation and chunk occupancy) ===\n");
+    fprintf(out, " %-6s | %-6s | %-10s | %-8s | %-8s | %-33s\n",
+            "BLOCK", "CHUNKS", "LIVE/CAP", "INTERNAL", "OVERHEAD", "OCCUPANCY [0-10% ... 90-100%]");
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        Pool_Class_Fragmentation *class = &report.pools.classes[i];
+        if (class->chunks == 0) continue;
+
+        char usage[24];
+        snprintf(usage, sizeof(usage), "%lu/%lu", (unsigned long)class->live_blocks, (unsigned long)class->capacity);
+
+        fprintf(out, " %-6zu | %-6lu | %-10s | %7.1f%% | %7.1f%% |", class->block_size, (unsigned long)class->chunks,
+                usage, class->internal_fragmentation * 100.0, class->chunk_overhead * 100.0);
+        for (int b = 0; b < POOL_OCCUPANCY_BUCKETS; b++) fprintf(out, " %lu", (unsigned long)class->occupancy[b]);
+        fprintf(out, "\n");
+    }
+    fprintf(out, "Empty chunks held by pool reserves: %lu (%lu bytes)\n",
+            (unsigned long)report.pools.reserved_chunks, (unsigned long)report.pools.reserved_bytes);
+}
+
+bool frag_export_page_map(FILE *out) {
+    if (out == NULL) return false;
+
+    Backend_Fragmentation frag = backend_get_fragmentation();
+    u32 max_order = backend_max_order();
+    size_t block_pages = (size_t)1 << max_order;
+
+    // Folga para blocos tirados da reserva entre as duas leituras; se não bastar, tenta de novo
+    size_t capacity = frag.committed_pages + 16 * block_pages;
+    size_t pages = 0;
+    u8 *owners = NULL;
+    u32 *live_bytes = NULL;
+
+    for (;;) {
+        owners = (u8*)frag_map_pages(capacity * (sizeof(u8) + sizeof(u32)));
+        if (owners == NULL) {
+            fprintf(stderr, "Error: Could not allocate page map [frag_export_page_map()]\n");
+            return false;
+        }
+        live_bytes = (u32*)(owners + capacity);
+
+        pages = backend_get_page_map(owners, capacity);
+        if (pages <= capacity) break;
+
+        munmap(owners, capacity * (sizeof(u8) + sizeof(u32)));
+        capacity = pages + 16 * block_pages;
+    }
+
+    // Páginas que não são de chunks (livres, heap, metadados das pools): sem ocupação por bloco
+    memset(live_bytes, 0xFF, pages * sizeof(u32));
+    pool_get_page_usage(live_bytes, pages);
+
+    size_t page_size = backend_page_size();
+
+    fprintf(out, "pagemap %d page_size=%zu max_order=%u pages=%zu huge_allocations=%zu huge_bytes=%zu\n",
+            FRAG_MAP_VERSION, page_size, max_order, pages, frag.huge_allocations, frag.huge_bytes);
+
+    for (size_t row = 0; row < pages; row += block_pages) {
+        fprintf(out, "%zu ", row);
+
+        for (size_t i = row; i < row + block_pages && i < pages; i++) {
+            char occupancy = '9';
+            if (owners[i] == BACKEND_PAGE_FREE) {
+                occupancy = '0';
+            } else if (live_bytes[i] != UINT32_MAX) {
+                size_t live = (live_bytes[i] < page_size) ? live_bytes[i] : page_size;
+                occupancy = (char)('0' + (live * 9 + page_size - 1) / page_size);
+            }
+
+            fputc(frag_owner_char(owners[i]), out);
+            fputc(occupancy, out);
+        }
+        fputc('\n', out);
+    }
+
+    munmap(owners, capacity * (sizeof(u8) + sizeof(u32)));
+    return true;
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+static char frag_owner_char(u8 owner) {
+    switch (owner) {
+        case BACKEND_PAGE_FREE: return '.';
+        case OWNER_ARENA:       return 'A';
+        case OWNER_POOL:        return 'P';
+        case OWNER_HEAP:        return 'H';
+        case OWNER_DEBUG:       return 'D';
+        default:                return 'N';
+    }
+}
+
+// Scratch fora do alocador: o mapa não altera o que está medindo
+static void *frag_map_pages(size_t bytes) {
+    void *memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (memory == MAP_FAILED) ? NULL : memory;
+}
@@ -0,0 +1,421 @@
+#define _GNU_SOURCE // syscall(SYS_gettid)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <execinfo.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "../include/guarded_pool.h"
+#include "../include/backend_manager.h"
+
+
+// ==========================
+//  ESTRUTURAS PRINCIPAIS
+// ==========================
+
+typedef enum Guarded_State {
+    GUARDED_SLOT_UNUSED,
+    GUARDED_SLOT_ALLOCATED,
+    GUARDED_SLOT_FREED
+} Guarded_State;
+
+typedef struct Guarded_Trace {
+    u32 tid;
+    u32 depth;
+    void *frames[GUARDED_MAX_FRAMES];
+} Guarded_Trace;
+
+typedef struct Guarded_Slot {
+    uintptr_t ptr;
+    size_t size;
+    Guarded_State state;
+    Guarded_Trace alloc_trace;
+    Guarded_Trace free_trace;
+} Guarded_Slot;
+
+uintptr_t guarded_region_start = 0;
+size_t guarded_region_size = 0;
+_Thread_local u32 guarded_countdown = 1; // Primeiro palloc de cada thread passa pelo caminho lento
+
+// Região: guarda, slot 0, guarda, slot 1, ..., guarda (slot i = página 2i + 1)
+static size_t guarded_page_size = 0;
+static u32 guarded_slot_count = 0;
+static u32 guarded_sample_rate = 0;
+static Guarded_Slot *guarded_slots = NULL;
+
+// Fila FIFO dos slots livres: o liberado há mais tempo é reusado primeiro (quarentena)
+static u32 *guarded_free_ring = NULL;
+static u32 guarded_ring_head = 0;
+static u32 guarded_ring_count = 0;
+
+static Guarded_Stats guarded_stats;
+static pthread_mutex_t guarded_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct sigaction guarded_previous_action;
+
+static _Thread_local u64 guarded_rng = 0;
+static _Thread_local bool guarded_thread_ready = false; // Thread já sorteou o primeiro intervalo com o modo ligado
+
+// DECLARAÇÕES
+static u32 guarded_next_countdown();
+static void guarded_capture(Guarded_Trace *trace) __attribute__((noinline));
+static void guarded_signal_handler(int signal, siginfo_t *info, void *context);
+static void guarded_forward_signal(int signal, siginfo_t *info, void *context);
+static void guarded_report(const char *error, uintptr_t address, const Guarded_Slot *slot);
+static void guarded_write(const char *text);
+static void guarded_write_number(u64 value, u32 base);
+static void guarded_write_frames(void *const *frames, u32 depth);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+/*
+Reserva a região e instala o handler de SIGSEGV. Chamar uma vez; outras threads que já alocaram
+entram na amostragem em até GUARDED_RECHECK_INTERVAL allocs.
+ */
+bool guarded_pool_init(u32 max_slots, u32 sample_rate) {
+    if (max_slots == 0) max_slots = GUARDED_DEFAULT_SLOTS;
+    if (sample_rate == 0) sample_rate = GUARDED_DEFAULT_SAMPLE_RATE;
+
+    pthread_mutex_lock(&guarded_lock);
+    if (guarded_region_size != 0) {
+        pthread_mutex_unlock(&guarded_lock);
+        fprintf(stderr, "Error: Guarded pool already initialized [guarded_pool_init()]\n");
+        return false;
+    }
+
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t region_size = (2 * (size_t)max_slots + 1) * page_size;
+    size_t metadata_size = max_slots * (sizeof(Guarded_Slot) + sizeof(u32));
+
+    void *region = mmap(NULL, region_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    void *metadata = mmap(NULL, metadata_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED || metadata == MAP_FAILED) {
+        if (region != MAP_FAILED) munmap(region, region_size);
+        if (metadata != MAP_FAILED) munmap(metadata, metadata_size);
+        pthread_mutex_unlock(&guarded_lock);
+        fprintf(stderr, "Error: Could not reserve guarded region [guarded_pool_init()]\n");
+        return false;
+    }
+
+    guarded_slots = (Guarded_Slot*)metadata;
+    guarded_free_ring = (u32*)(guarded_slots + max_slots);
+    for (u32 i = 0; i < max_slots; i++) guarded_free_ring[i] = i;
+    guarded_ring_head = 0;
+    guarded_ring_count = max_slots;
+
+    guarded_page_size = page_size;
+    guarded_slot_count = max_slots;
+    guarded_sample_rate = sample_rate;
+    memset(&guarded_stats, 0, sizeof(guarded_stats));
+
+    // O primeiro backtrace() carrega a libgcc_s: fora do handler e do caminho de alocação
+    void *warmup[2];
+    backtrace(warmup, 2);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = guarded_signal_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &guarded_previous_action);
+
+    guarded_region_start = (uintptr_t)region;
+    __atomic_store_n(&guarded_region_size, region_size, __ATOMIC_RELEASE);
+    guarded_countdown = guarded_next_countdown();
+    guarded_thread_ready = true;
+
+    pthread_mutex_unlock(&guarded_lock);
+    return true;
+}
+
+Guarded_Stats guarded_pool_get_stats() {
+    pthread_mutex_lock(&guarded_lock);
+    Guarded_Stats stats = guarded_stats;
+    pthread_mutex_unlock(&guarded_lock);
+    return stats;
+}
+
+/*
+Caminho lento do palloc (guarded_should_sample()). Sorteia o próximo intervalo da thread e tenta um slot.
+A primeira passagem de cada thread (countdown inicial = 1) só sorteia: senão toda thread nova levaria
+um slot no primeiro palloc e a taxa deixaria de ser ~1 em sample_rate.
+ */
+void *guarded_alloc(size_t size) {
+    if (__atomic_load_n(&guarded_region_size, __ATOMIC_ACQUIRE) == 0) {
+        guarded_countdown = GUARDED_RECHECK_INTERVAL;
+        return NULL;
+    }
+
+    guarded_countdown = guarded_next_countdown();
+    if (!guarded_thread_ready) {
+        guarded_thread_ready = true;
+        return NULL;
+    }
+
+    if (size == 0 || size > guarded_page_size) {
+        __atomic_fetch_add(&guarded_stats.skipped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&guarded_lock);
+    if (guarded_ring_count == 0) {
+        guarded_stats.skipped++;
+        pthread_mutex_unlock(&guarded_lock);
+        return NULL;
+    }
+
+    u32 index = guarded_free_ring[guarded_ring_head];
+    guarded_ring_head = (guarded_ring_head + 1) % guarded_slot_count;
+    guarded_ring_count--;
+
+    Guarded_Slot *slot = &guarded_slots[index];
+    uintptr_t page = guarded_region_start + (2 * (size_t)index + 1) * guarded_page_size;
+    mprotect((void*)page, guarded_page_size, PROT_READ | PROT_WRITE);
+
+    // Encostado na guarda da direita, respeitando o alinhamento que a classe do palloc daria
+    size_t alignment = (size >= DEFAULT_ALIGNMENT) ? DEFAULT_ALIGNMENT : sizeof(void*);
+    size_t padded = (size + alignment - 1) & ~(alignment - 1);
+
+    slot->ptr = page + guarded_page_size - padded;
+    slot->size = size;
+    slot->state = GUARDED_SLOT_ALLOCATED;
+    guarded_capture(&slot->alloc_trace);
+    slot->free_trace.depth = 0;
+
+    guarded_stats.allocs++;
+    guarded_stats.in_use++;
+    pthread_mutex_unlock(&guarded_lock);
+
+    return (void*)slot->ptr;
+}
+
+/*
+Free de um ponteiro da região (guarded_owns()). Erros de uso são fatais: relatório e abort().
+ */
+void guarded_free(void *ptr) {
+    uintptr_t address = (uintptr_t)ptr;
+    size_t page_index = (address - guarded_region_start) / guarded_page_size;
+
+    pthread_mutex_lock(&guarded_lock);
+
+    // Página par = guarda
+    if (page_index % 2 == 0) {
+        pthread_mutex_unlock(&guarded_lock);
+        guarded_report("invalid free (guard page)", address, NULL);
+        abort();
+    }
+
+    Guarded_Slot *slot = &guarded_slots[page_index / 2];
+    if (slot->state == GUARDED_SLOT_FREED) {
+        pthread_mutex_unlock(&guarded_lock);
+        guarded_report("double free", address, slot);
+        abort();
+    }
+    if (slot->state != GUARDED_SLOT_ALLOCATED || slot->ptr != address) {
+        pthread_mutex_unlock(&guarded_lock);
+        guarded_report("invalid free (not the start of a block)", address, slot);
+        abort();
+    }
+
+    slot->state = GUARDED_SLOT_FREED;
+    guarded_capture(&slot->free_trace);
+
+    // Inacessível até o reuso; o DONTNEED devolve a página e a próxima alocação já vem zerada
+    uintptr_t page = address & ~(guarded_page_size - 1);
+    mprotect((void*)page, guarded_page_size, PROT_NONE);
+    madvise((void*)page, guarded_page_size, MADV_DONTNEED);
+
+    guarded_free_ring[(guarded_ring_head + guarded_ring_count) % guarded_slot_count] = (u32)(page_index / 2);
+    guarded_ring_count++;
+
+    guarded_stats.frees++;
+    guarded_stats.in_use--;
+    pthread_mutex_unlock(&guarded_lock);
+}
+
+size_t guarded_usable_size(void *ptr) {
+    size_t page_index = ((uintptr_t)ptr - guarded_region_start) / guarded_page_size;
+    if (page_index % 2 == 0) return 0;
+
+    Guarded_Slot *slot = &guarded_slots[page_index / 2];
+    return (slot->state == GUARDED_SLOT_ALLOCATED) ? slot->size : 0;
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+// Uniforme em [1, 2 * sample_rate]: média sample_rate (xorshift64* por thread)
+static u32 guarded_next_countdown() {
+    if (guarded_rng == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        guarded_rng = ((u64)(uintptr_t)&guarded_rng ^ ((u64)ts.tv_nsec << 20) ^ (u64)ts.tv_sec) | 1;
+    }
+
+    guarded_rng ^= guarded_rng >> 12;
+    guarded_rng ^= guarded_rng << 25;
+    guarded_rng ^= guarded_rng >> 27;
+    u64 random = guarded_rng * 0x2545F4914F6CDD1DULL;
+
+    return 1 + (u32)((random >> 32) % (2 * (u64)guarded_sample_rate));
+}
+
+static void guarded_capture(Guarded_Trace *trace) {
+    void *frames[GUARDED_MAX_FRAMES + 1];
+    int depth = backtrace(frames, GUARDED_MAX_FRAMES + 1);
+
+    // Descarta o próprio guarded_capture() (noinline: o frame seguinte é sempre guarded_alloc()/guarded_free())
+    depth = (depth > 1) ? depth - 1 : 0;
+    memcpy(trace->frames, frames + 1, (size_t)depth * sizeof(void*));
+    trace->depth = (u32)depth;
+    trace->tid = (u32)syscall(SYS_gettid);
+}
+
+/*
+Falha dentro da região: página de slot liberado = use-after-free; guarda = overflow do slot da esquerda
+(blocos encostados à direita) ou underflow do da direita. Depois do relatório o handler anterior volta
+e a instrução falha de novo sob ele (core dump no padrão).
+Falhas fora da região vão direto para o handler anterior, e o guarded pool continua instalado.
+ */
+static void guarded_signal_handler(int signal, siginfo_t *info, void *context) {
+    uintptr_t address = (uintptr_t)info->si_addr;
+
+    if (signal != SIGSEGV || address - guarded_region_start >= guarded_region_size) {
+        guarded_forward_signal(signal, info, context);
+        return;
+    }
+
+    size_t page_index = (address - guarded_region_start) / guarded_page_size;
+    const Guarded_Slot *slot = NULL;
+    const char *error = "wild access";
+
+    if (page_index % 2 == 1) {
+        slot = &guarded_slots[page_index / 2];
+        if (slot->state == GUARDED_SLOT_FREED) error = "use-after-free";
+    } else {
+        const Guarded_Slot *left = (page_index > 0) ? &guarded_slots[page_index / 2 - 1] : NULL;
+        const Guarded_Slot *right = (page_index / 2 < guarded_slot_count) ? &guarded_slots[page_index / 2] : NULL;
+
+        if (left != NULL && left->state != GUARDED_SLOT_UNUSED) {
+            slot = left;
+            error = (left->state == GUARDED_SLOT_FREED) ? "use-after-free (past the end)" : "buffer overflow";
+        } else if (right != NULL && right->state != GUARDED_SLOT_UNUSED) {
+            slot = right;
+            error = (right->state == GUARDED_SLOT_FREED) ? "use-after-free (before the start)" : "buffer underflow";
+        }
+    }
+
+    guarded_report(error, address, slot);
+    sigaction(SIGSEGV, &guarded_previous_action, NULL);
+}
+
+// Encadeia com o handler instalado antes do guarded_pool_init()
+static void guarded_forward_signal(int signal, siginfo_t *info, void *context) {
+    if (guarded_previous_action.sa_flags & SA_SIGINFO) {
+        guarded_previous_action.sa_sigaction(signal, info, context);
+        return;
+    }
+
+    // SIG_DFL/SIG_IGN: uma falha de memória não pode ser ignorada; a instrução falha de novo sob o padrão
+    if (guarded_previous_action.sa_handler == SIG_DFL || guarded_previous_action.sa_handler == SIG_IGN) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = SIG_DFL;
+        sigemptyset(&action.sa_mask);
+        sigaction(signal, &action, NULL);
+        return;
+    }
+
+    guarded_previous_action.sa_handler(signal);
+}
+
+/*
+Relatório só com write(): sai de dentro do handler de sinal. Frames em hexadecimal cru
+(símbolos: addr2line -f -e <binário> <endereço - base>); o backtrace() já foi carregado no init.
+ */
+static void guarded_report(const char *error, uintptr_t address, const Guarded_Slot *slot) {
+    guarded_write("\n==");
+    guarded_write_number((u64)getpid(), 10);
+    guarded_write("== Guarded pool: ");
+    guarded_write(error);
+    guarded_write(" at 0x");
+    guarded_write_number(address, 16);
+    guarded_write("\n");
+
+    bool has_slot = (slot != NULL && slot->state != GUARDED_SLOT_UNUSED);
+    if (has_slot) {
+        guarded_write("Block 0x");
+        guarded_write_number(slot->ptr, 16);
+        guarded_write(" of ");
+        guarded_write_number(slot->size, 10);
+        guarded_write(" bytes (offset ");
+        if (address < slot->ptr) {
+            guarded_write("-");
+            guarded_write_number(slot->ptr - address, 10);
+        } else {
+            guarded_write_number(address - slot->ptr, 10);
+        }
+        guarded_write(")\n");
+    }
+
+    void *frames[GUARDED_MAX_FRAMES];
+    int depth = backtrace(frames, GUARDED_MAX_FRAMES);
+    guarded_write("Current thread ");
+    guarded_write_number((u64)syscall(SYS_gettid), 10);
+    guarded_write(":\n");
+    guarded_write_frames(frames, (depth > 0) ? (u32)depth : 0);
+
+    if (has_slot) {
+        guarded_write("Allocated by thread ");
+        guarded_write_number(slot->alloc_trace.tid, 10);
+        guarded_write(":\n");
+        guarded_write_frames(slot->alloc_trace.frames, slot->alloc_trace.depth);
+
+        if (slot->state == GUARDED_SLOT_FREED) {
+            guarded_write("Freed by thread ");
+            guarded_write_number(slot->free_trace.tid, 10);
+            guarded_write(":\n");
+            guarded_write_frames(slot->free_trace.frames, slot->free_trace.depth);
+        }
+    }
+}
+
+static void guarded_write(const char *text) {
+    size_t length = strlen(text);
+    while (length > 0) {
+        ssize_t written = write(STDERR_FILENO, text, length);
+        if (written <= 0) return;
+        text += written;
+        length -= (size_t)written;
+    }
+}
+
+static void guarded_write_number(u64 value, u32 base) {
+    char buffer[24];
+    size_t pos = sizeof(buffer) - 1;
+    buffer[pos] = '\0';
+
+    do {
+        buffer[--pos] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value != 0);
+
+    guarded_write(&buffer[pos]);
+}
+
+static void guarded_write_frames(void *const *frames, u32 depth) {
+    for (u32 i = 0; i < depth; i++) {
+        guarded_write("  #");
+        guarded_write_number(i, 10);
+        guarded_write(" 0x");
+        guarded_write_number((uintptr_t)frames[i], 16);
+        guarded_write("\n");
+    }
+}
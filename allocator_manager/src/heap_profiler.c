@@ -0,0 +1,330 @@
+#define _GNU_SOURCE // dladdr()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <execinfo.h>
+#include <sys/mman.h>
+
+#include "../include/heap_profiler.h"
+
+
+// ==========================
+//  ESTRUTURAS PRINCIPAIS
+// ==========================
+
+#define HEAP_PROFILER_BUCKETS 16384          // Potência de 2
+#define HEAP_PROFILER_SLAB_SIZE (64 * 1024)  // Registros vêm de mmap: o profiler não chama o alocador que mede
+
+// Objeto amostrado e ainda vivo
+typedef struct Heap_Sample {
+    struct Heap_Sample *next; // Bucket (vivo) ou lista de livres
+    void *ptr;
+    size_t size;
+    u64 weight;     // Bytes estimados que a amostra representa
+    u64 stack_hash;
+    u32 depth;
+    void *frames[HEAP_PROFILER_MAX_FRAMES];
+} Heap_Sample;
+
+typedef struct Heap_Slab {
+    struct Heap_Slab *next;
+} Heap_Slab;
+
+bool heap_profiler_enabled = false;
+_Thread_local i64 heap_profiler_bytes_left = 0;
+
+// Lido sem lock no free: bucket vazio = o ponteiro com certeza não foi amostrado
+static Heap_Sample *heap_buckets[HEAP_PROFILER_BUCKETS];
+static Heap_Sample *heap_free_samples = NULL;
+static Heap_Slab *heap_slabs = NULL;
+static size_t heap_live_samples = 0;
+
+static double heap_mean_interval = HEAP_PROFILER_DEFAULT_INTERVAL;
+static u32 heap_generation = 0; // Muda a cada start: as threads sorteiam um novo intervalo
+
+static _Thread_local u32 heap_thread_generation = 0;
+static _Thread_local u64 heap_thread_rng = 0;
+
+static pthread_mutex_t heap_profiler_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// DECLARAÇÕES
+static size_t heap_hash_ptr(void *ptr);
+static u64 heap_hash_stack(void **frames, u32 depth);
+static i64 heap_next_interval();
+static Heap_Sample *heap_new_sample();
+static void heap_release_all();
+static int heap_compare_stacks(const void *a, const void *b);
+static void heap_print_frame(FILE *out, void *frame);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+bool heap_profiler_start(size_t mean_interval) {
+    if (mean_interval == 0) mean_interval = HEAP_PROFILER_DEFAULT_INTERVAL;
+
+    // O primeiro backtrace() carrega a libgcc_s; melhor aqui do que no meio de uma alocação
+    void *warmup[2];
+    backtrace(warmup, 2);
+
+    pthread_mutex_lock(&heap_profiler_lock);
+    if (heap_profiler_enabled) {
+        pthread_mutex_unlock(&heap_profiler_lock);
+        fprintf(stderr, "Error: Heap profiler already running [heap_profiler_start()]\n");
+        return false;
+    }
+
+    heap_release_all();
+    heap_mean_interval = (double)mean_interval;
+    heap_generation++;
+    __atomic_store_n(&heap_profiler_enabled, true, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&heap_profiler_lock);
+    return true;
+}
+
+/*
+Para a amostragem e descarta as amostras vivas (o dump deve vir antes).
+ */
+void heap_profiler_stop() {
+    pthread_mutex_lock(&heap_profiler_lock);
+    __atomic_store_n(&heap_profiler_enabled, false, __ATOMIC_RELEASE);
+    heap_release_all();
+    pthread_mutex_unlock(&heap_profiler_lock);
+}
+
+/*
+Chamada quando a thread passa do intervalo. O backtrace é tirado antes do lock.
+ */
+void heap_profiler_sample(void *ptr, size_t size) {
+    // Thread nova (ou profiler reiniciado): sorteia o intervalo; a alocação atual só conta para ele
+    if (heap_thread_generation != __atomic_load_n(&heap_generation, __ATOMIC_RELAXED)) {
+        heap_thread_generation = __atomic_load_n(&heap_generation, __ATOMIC_RELAXED);
+        heap_profiler_bytes_left = heap_next_interval();
+        return;
+    }
+
+    // Alocação que falhou: a próxima é amostrada no lugar dela
+    if (ptr == NULL) return;
+
+    heap_profiler_bytes_left = heap_next_interval();
+
+    void *frames[HEAP_PROFILER_MAX_FRAMES + 1];
+    int depth = backtrace(frames, HEAP_PROFILER_MAX_FRAMES + 1);
+    if (depth <= 1) return;
+    depth--; // Descarta o próprio heap_profiler_sample()
+
+    double mean = heap_mean_interval;
+    double scale = 1.0 / (1.0 - exp(-(double)size / mean));
+
+    pthread_mutex_lock(&heap_profiler_lock);
+    if (!heap_profiler_enabled) {
+        pthread_mutex_unlock(&heap_profiler_lock);
+        return;
+    }
+
+    Heap_Sample *sample = heap_new_sample();
+    if (sample == NULL) {
+        pthread_mutex_unlock(&heap_profiler_lock);
+        return;
+    }
+
+    sample->ptr = ptr;
+    sample->size = size;
+    sample->weight = (u64)((double)size * scale + 0.5);
+    sample->depth = (u32)depth;
+    memcpy(sample->frames, frames + 1, (size_t)depth * sizeof(void*));
+    sample->stack_hash = heap_hash_stack(sample->frames, sample->depth);
+
+    size_t bucket = heap_hash_ptr(ptr);
+    sample->next = heap_buckets[bucket];
+    __atomic_store_n(&heap_buckets[bucket], sample, __ATOMIC_RELEASE);
+    heap_live_samples++;
+
+    pthread_mutex_unlock(&heap_profiler_lock);
+}
+
+/*
+Free com o profiler ligado. O objeto foi inserido antes de ser entregue a quem o libera,
+então um bucket vazio lido sem lock já responde pela maioria dos frees.
+ */
+void heap_profiler_forget(void *ptr) {
+    size_t bucket = heap_hash_ptr(ptr);
+    if (__atomic_load_n(&heap_buckets[bucket], __ATOMIC_ACQUIRE) == NULL) return;
+
+    pthread_mutex_lock(&heap_profiler_lock);
+    for (Heap_Sample **link = &heap_buckets[bucket]; *link != NULL; link = &(*link)->next) {
+        Heap_Sample *sample = *link;
+        if (sample->ptr != ptr) continue;
+
+        __atomic_store_n(link, sample->next, __ATOMIC_RELEASE);
+        sample->next = heap_free_samples;
+        heap_free_samples = sample;
+        heap_live_samples--;
+        break;
+    }
+    pthread_mutex_unlock(&heap_profiler_lock);
+}
+
+/*
+Perfil dos objetos amostrados vivos: uma linha por pilha distinta, frames da raiz para a folha
+separados por ';' e o total estimado de bytes. Símbolos via dladdr() (binários linkados com -rdynamic);
+sem símbolo, o frame sai como "objeto+0xoffset", para o addr2line.
+ */
+bool heap_profiler_dump_collapsed(FILE *out) {
+    if (out == NULL) return false;
+
+    // Cópia das amostras: símbolos e fprintf ficam fora do lock
+    pthread_mutex_lock(&heap_profiler_lock);
+    size_t count = heap_live_samples;
+    Heap_Sample *copy = NULL;
+    size_t copy_size = (count > 0) ? count * sizeof(Heap_Sample) : 1;
+
+    void *memory = mmap(NULL, copy_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        pthread_mutex_unlock(&heap_profiler_lock);
+        fprintf(stderr, "Error: Could not allocate heap profile snapshot [heap_profiler_dump_collapsed()]\n");
+        return false;
+    }
+    copy = (Heap_Sample*)memory;
+
+    size_t n = 0;
+    for (size_t b = 0; b < HEAP_PROFILER_BUCKETS && n < count; b++) {
+        for (Heap_Sample *sample = heap_buckets[b]; sample != NULL && n < count; sample = sample->next) {
+            copy[n++] = *sample;
+        }
+    }
+    pthread_mutex_unlock(&heap_profiler_lock);
+
+    qsort(copy, n, sizeof(Heap_Sample), heap_compare_stacks);
+
+    for (size_t i = 0; i < n;) {
+        u64 bytes = 0;
+        size_t j = i;
+        while (j < n && heap_compare_stacks(&copy[i], &copy[j]) == 0) bytes += copy[j++].weight;
+
+        for (u32 f = copy[i].depth; f > 0; f--) {
+            heap_print_frame(out, copy[i].frames[f - 1]);
+            if (f > 1) fputc(';', out);
+        }
+        fprintf(out, " %lu\n", (unsigned long)bytes);
+        i = j;
+    }
+
+    munmap(memory, copy_size);
+    return true;
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+static size_t heap_hash_ptr(void *ptr) {
+    u64 x = (u64)(uintptr_t)ptr;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return (size_t)(x & (HEAP_PROFILER_BUCKETS - 1));
+}
+
+// FNV-1a sobre os endereços de retorno
+static u64 heap_hash_stack(void **frames, u32 depth) {
+    u64 hash = 0xCBF29CE484222325ULL;
+    for (u32 i = 0; i < depth; i++) {
+        hash ^= (u64)(uintptr_t)frames[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/*
+Bytes até a próxima amostra: -ln(U) * média, com U uniforme em (0, 1] (xorshift64* por thread).
+ */
+static i64 heap_next_interval() {
+    if (heap_thread_rng == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        heap_thread_rng = ((u64)(uintptr_t)&heap_thread_rng ^ ((u64)ts.tv_nsec << 20) ^ (u64)ts.tv_sec) | 1;
+    }
+
+    heap_thread_rng ^= heap_thread_rng >> 12;
+    heap_thread_rng ^= heap_thread_rng << 25;
+    heap_thread_rng ^= heap_thread_rng >> 27;
+    u64 bits = (heap_thread_rng * 0x2545F4914F6CDD1DULL) >> 11; // 53 bits
+
+    double uniform = ((double)bits + 1.0) / 9007199254740992.0; // (0, 1]
+    double interval = -log(uniform) * heap_mean_interval;
+
+    return (interval < 1.0) ? 1 : (i64)interval;
+}
+
+// Chamada com o lock
+static Heap_Sample *heap_new_sample() {
+    if (heap_free_samples == NULL) {
+        void *memory = mmap(NULL, HEAP_PROFILER_SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return NULL;
+
+        Heap_Slab *slab = (Heap_Slab*)memory;
+        slab->next = heap_slabs;
+        heap_slabs = slab;
+
+        // Primeiro registro começa depois do header do slab
+        Heap_Sample *samples = (Heap_Sample*)((u8*)memory + sizeof(Heap_Sample));
+        size_t capacity = HEAP_PROFILER_SLAB_SIZE / sizeof(Heap_Sample) - 1;
+        for (size_t i = 0; i < capacity; i++) {
+            samples[i].next = heap_free_samples;
+            heap_free_samples = &samples[i];
+        }
+    }
+
+    Heap_Sample *sample = heap_free_samples;
+    heap_free_samples = sample->next;
+    return sample;
+}
+
+// Chamada com o lock
+static void heap_release_all() {
+    for (size_t b = 0; b < HEAP_PROFILER_BUCKETS; b++) {
+        __atomic_store_n(&heap_buckets[b], NULL, __ATOMIC_RELEASE);
+    }
+
+    while (heap_slabs != NULL) {
+        Heap_Slab *next = heap_slabs->next;
+        munmap(heap_slabs, HEAP_PROFILER_SLAB_SIZE);
+        heap_slabs = next;
+    }
+
+    heap_free_samples = NULL;
+    heap_live_samples = 0;
+}
+
+static int heap_compare_stacks(const void *a, const void *b) {
+    const Heap_Sample *left = (const Heap_Sample*)a;
+    const Heap_Sample *right = (const Heap_Sample*)b;
+
+    if (left->stack_hash != right->stack_hash) return (left->stack_hash < right->stack_hash) ? -1 : 1;
+    if (left->depth != right->depth) return (left->depth < right->depth) ? -1 : 1;
+    return memcmp(left->frames, right->frames, left->depth * sizeof(void*));
+}
+
+static void heap_print_frame(FILE *out, void *frame) {
+    Dl_info info;
+
+    if (dladdr(frame, &info) != 0) {
+        if (info.dli_sname != NULL) {
+            fputs(info.dli_sname, out);
+            return;
+        }
+        if (info.dli_fname != NULL) {
+            const char *name = strrchr(info.dli_fname, '/');
+            fprintf(out, "%s+0x%lx", name ? name + 1 : info.dli_fname,
+                    (unsigned long)((uintptr_t)frame - (uintptr_t)info.dli_fbase));
+            return;
+        }
+    }
+
+    fprintf(out, "0x%lx", (unsigned long)(uintptr_t)frame);
+}
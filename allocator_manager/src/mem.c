@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/mem.h"
+#include "../include/backend_manager.h"
+#include "../include/pool.h"
+#include "../include/guarded_pool.h"
+#include "../include/utilities.h"
+
+
+// DECLARAÇÕES
+static size_t mem_class_size(size_t size);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+void *mem_alloc(size_t size) {
+    if (size == 0) return NULL;
+
+    if (size <= MAX_POOL_BLOCK_SIZE) {
+        return palloc(size);
+    }
+
+    // backend_alloc desvia sozinho para o caminho huge acima da ordem máxima
+    return backend_alloc(size, OWNER_HEAP);
+}
+
+/*
+Memória zerada de count * size bytes (NULL em overflow). Páginas que o backend sabe estarem zeradas não passam por memset.
+ */
+void *mem_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+
+    size_t total = count * size;
+    if (total == 0) return NULL;
+
+    if (total <= MAX_POOL_BLOCK_SIZE) {
+        return pcalloc(total);
+    }
+
+    return backend_calloc(total, OWNER_HEAP);
+}
+
+void mem_free(void *ptr) {
+    if (ptr == NULL) return;
+
+    // Fora da reserva: huge ou bloco amostrado pelo guarded pool
+    if (is_huge_allocation(ptr)) {
+        if (guarded_owns(ptr)) {
+            guarded_free(ptr);
+            return;
+        }
+        backend_free(ptr);
+        return;
+    }
+
+    Page_Descriptor *descriptor = get_descriptor(ptr);
+    if (descriptor == NULL) return;
+
+    switch (descriptor->owner_id) {
+        case OWNER_POOL:
+            pool_free(ptr);
+            break;
+        // Blocos inteiros do backend (backend_alloc com esse dono)
+        case OWNER_HEAP:
+        case OWNER_ARENA:
+            backend_free(ptr);
+            break;
+        default:
+            fprintf(stderr, "Error: Invalid free request [mem_free()]\n");
+            break;
+    }
+}
+
+/*
+Mesma classe (pool genérica, ordem do backend ou número de páginas huge): devolve o próprio ptr.
+Senão aloca na classe nova e copia min(antigo, novo) bytes.
+Blocos de pool vão para prealloc(), que mantém o tempo de vida do palloc_hint() ao mudar de classe.
+ */
+void *mem_realloc(void *ptr, size_t new_size) {
+    if (ptr == NULL) return mem_alloc(new_size);
+
+    if (!is_huge_allocation(ptr)) {
+        Page_Descriptor *descriptor = get_descriptor(ptr);
+        if (descriptor != NULL && descriptor->owner_id == OWNER_POOL) return prealloc(ptr, new_size);
+    }
+
+    if (new_size == 0) {
+        mem_free(ptr);
+        return NULL;
+    }
+
+    size_t old_size = mem_usable_size(ptr);
+    if (old_size == 0) return NULL;
+
+    if (mem_class_size(new_size) == old_size) return ptr;
+
+    void *new_ptr = mem_alloc(new_size);
+    if (new_ptr == NULL) return NULL;
+
+    memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+    mem_free(ptr);
+
+    return new_ptr;
+}
+
+size_t mem_usable_size(void *ptr) {
+    if (ptr == NULL) return 0;
+
+    if (is_huge_allocation(ptr)) {
+        if (guarded_owns(ptr)) return guarded_usable_size(ptr);
+        return backend_usable_size(ptr);
+    }
+
+    Page_Descriptor *descriptor = get_descriptor(ptr);
+    if (descriptor == NULL) return 0;
+
+    switch (descriptor->owner_id) {
+        case OWNER_POOL:  return pool_usable_size(ptr);
+        case OWNER_HEAP:
+        case OWNER_ARENA: return backend_usable_size(ptr);
+        default:          return 0;
+    }
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+/*
+Tamanho que mem_alloc(size) entregaria: classe da pool genérica,
+bloco da ordem no backend, páginas inteiras no huge.
+ */
+static size_t mem_class_size(size_t size) {
+    if (size <= MAX_POOL_BLOCK_SIZE) {
+        return pool_class_size(size);
+    }
+
+    if (size <= REQUEST_SIZE_FROM_ORDER(backend_max_order())) {
+        return REQUEST_SIZE_FROM_ORDER(get_order(size));
+    }
+
+    size_t page_size = backend_page_size();
+    return ((size + page_size - 1) / page_size) * page_size;
+}
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "../include/mm_stats.h"
+
+
+// ==========================
+//  ESTRUTURAS PRINCIPAIS
+// ==========================
+
+static Mm_Stats_Shard mm_stats_shards[MM_STATS_MAX_SHARDS];
+static Mm_Stats_Shard mm_stats_overflow = { .shared = true };
+static u32 mm_stats_shard_count = 0; // Shards já entregues alguma vez (os leitores só percorrem esses)
+
+// Shards de threads encerradas, prontos para reuso
+static u32 mm_stats_free_shards[MM_STATS_MAX_SHARDS];
+static u32 mm_stats_free_count = 0;
+
+static pthread_mutex_t mm_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t mm_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t mm_stats_key;
+
+// Base dos caminhos lentos (mm_slow_path_reset) e origem da conversão ticks -> ns
+static i64 mm_slow_base_events[MM_SLOW_PATH_COUNT];
+static i64 mm_slow_base_depth[MM_SLOW_PATH_COUNT];
+static i64 mm_slow_base_ticks[MM_SLOW_PATH_COUNT];
+static u64 mm_slow_reset_ns = 0;
+static u64 mm_clock_origin_ns = 0;
+static u64 mm_clock_origin_ticks = 0;
+
+_Thread_local Mm_Stats_Shard *mm_stats_tls = NULL;
+
+// DECLARAÇÕES
+static void mm_stats_init_key();
+static void mm_stats_detach(void *shard);
+static void mm_stats_sum(Mm_Stats_Shard *sum);
+static u64 mm_stats_nanos();
+static double mm_stats_ns_per_tick();
+static u64 mm_stats_gauge(i64 value);
+static const char *mm_stats_owner_name(u32 owner);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+/*
+Primeiro contador da thread: pega um shard livre (ou nunca usado). Sem shard, a thread
+passa a usar o shard de transbordo, com incrementos atômicos.
+ */
+Mm_Stats_Shard *mm_stats_attach() {
+    pthread_once(&mm_stats_once, mm_stats_init_key);
+
+    Mm_Stats_Shard *shard = &mm_stats_overflow;
+
+    pthread_mutex_lock(&mm_stats_lock);
+    if (mm_stats_free_count > 0) {
+        shard = &mm_stats_shards[mm_stats_free_shards[--mm_stats_free_count]];
+    } else if (mm_stats_shard_count < MM_STATS_MAX_SHARDS) {
+        shard = &mm_stats_shards[mm_stats_shard_count];
+        __atomic_store_n(&mm_stats_shard_count, mm_stats_shard_count + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&mm_stats_lock);
+
+    if (shard != &mm_stats_overflow) {
+        pthread_setspecific(mm_stats_key, shard);
+    }
+
+    mm_stats_tls = shard;
+    return shard;
+}
+
+Mm_Stats mm_stats_get() {
+    Mm_Stats_Shard sum;
+    mm_stats_sum(&sum);
+
+    Mm_Stats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.page_size = backend_page_size();
+
+    size_t block_size = 0;
+    size_t pool_live_bytes = 0;
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        Mm_Stats_Class *class = &stats.classes[i];
+        block_size = pool_class_size(block_size + 1);
+
+        class->block_size = block_size;
+        class->allocs = mm_stats_gauge(sum.class_allocs[i]);
+        class->frees = mm_stats_gauge(sum.class_frees[i]);
+        class->requested_bytes = mm_stats_gauge(sum.class_requested[i]);
+        class->live_blocks = (class->allocs > class->frees) ? class->allocs - class->frees : 0;
+        class->chunks = mm_stats_gauge(sum.class_chunks[i]);
+        pool_live_bytes += class->live_blocks * class->block_size;
+    }
+
+    for (int o = 0; o < MM_STATS_OWNER_COUNT; o++) {
+        stats.owners[o].committed_pages = mm_stats_gauge(sum.owner_pages[o]);
+        stats.owners[o].used_pages = mm_stats_gauge(sum.owner_used_pages[o]);
+    }
+
+    // Chunks das pools: o backend vê o chunk inteiro como pedido; o uso real são os blocos vivos
+    if (stats.page_size > 0) {
+        u64 pool_used = (pool_live_bytes + stats.page_size - 1) / stats.page_size;
+        Mm_Stats_Owner *pool = &stats.owners[OWNER_POOL];
+        pool->used_pages = (pool_used < pool->committed_pages) ? pool_used : pool->committed_pages;
+    }
+
+    stats.huge_bytes = mm_stats_gauge(sum.huge_bytes);
+    stats.huge_allocs = mm_stats_gauge(sum.huge_allocs);
+    stats.huge_frees = mm_stats_gauge(sum.huge_frees);
+    stats.reserve_committed_pages = mm_stats_gauge(sum.reserve_pages);
+    stats.reserve_refills = mm_stats_gauge(sum.reserve_refills);
+    stats.purges = mm_stats_gauge(sum.purges);
+    stats.purged_pages = mm_stats_gauge(sum.purged_pages);
+    stats.pool_refills = mm_stats_gauge(sum.pool_refills);
+
+    return stats;
+}
+
+void mm_stats_dump_json(FILE *out) {
+    Mm_Stats stats = mm_stats_get();
+
+    fprintf(out, "{\"page_size\":%zu,\"classes\":[", stats.page_size);
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        Mm_Stats_Class *class = &stats.classes[i];
+        fprintf(out, "%s{\"block_size\":%zu,\"allocs\":%lu,\"frees\":%lu,\"requested_bytes\":%lu,\"live_blocks\":%lu,\"chunks\":%lu}",
+                i ? "," : "", class->block_size, (unsigned long)class->allocs, (unsigned long)class->frees,
+                (unsigned long)class->requested_bytes, (unsigned long)class->live_blocks, (unsigned long)class->chunks);
+    }
+
+    fprintf(out, "],\"owners\":{");
+    for (int o = 0; o < MM_STATS_OWNER_COUNT; o++) {
+        fprintf(out, "%s\"%s\":{\"committed_pages\":%lu,\"used_pages\":%lu}", o ? "," : "", mm_stats_owner_name(o),
+                (unsigned long)stats.owners[o].committed_pages, (unsigned long)stats.owners[o].used_pages);
+    }
+
+    fprintf(out, "},\"huge\":{\"bytes\":%lu,\"allocs\":%lu,\"frees\":%lu}",
+            (unsigned long)stats.huge_bytes, (unsigned long)stats.huge_allocs, (unsigned long)stats.huge_frees);
+    fprintf(out, ",\"reserve\":{\"committed_pages\":%lu,\"refills\":%lu}",
+            (unsigned long)stats.reserve_committed_pages, (unsigned long)stats.reserve_refills);
+    fprintf(out, ",\"purge\":{\"calls\":%lu,\"pages\":%lu},\"pool_refills\":%lu",
+            (unsigned long)stats.purges, (unsigned long)stats.purged_pages, (unsigned long)stats.pool_refills);
+
+    Mm_Slow_Path_Snapshot slow = mm_slow_path_snapshot();
+    fprintf(out, ",\"slow_paths\":{\"elapsed_ns\":%lu", (unsigned long)slow.elapsed_ns);
+    for (int p = 0; p < MM_SLOW_PATH_COUNT; p++) {
+        fprintf(out, ",\"%s\":{\"events\":%lu,\"depth\":%lu,\"total_ns\":%lu}", mm_slow_path_name(p),
+                (unsigned long)slow.paths[p].events, (unsigned long)slow.paths[p].depth, (unsigned long)slow.paths[p].total_ns);
+    }
+    fprintf(out, "}}\n");
+}
+
+void mm_slow_path_reset() {
+    pthread_once(&mm_stats_once, mm_stats_init_key);
+
+    Mm_Stats_Shard sum;
+    mm_stats_sum(&sum);
+
+    pthread_mutex_lock(&mm_stats_lock);
+    memcpy(mm_slow_base_events, sum.slow_events, sizeof(mm_slow_base_events));
+    memcpy(mm_slow_base_depth, sum.slow_depth, sizeof(mm_slow_base_depth));
+    memcpy(mm_slow_base_ticks, sum.slow_ticks, sizeof(mm_slow_base_ticks));
+    mm_slow_reset_ns = mm_stats_nanos();
+    pthread_mutex_unlock(&mm_stats_lock);
+}
+
+/*
+Caminhos lentos desde o último reset. Os ticks são convertidos pela razão TSC/CLOCK_MONOTONIC medida
+desde a origem (primeiro contador), esperando até MM_STATS_CALIBRATION_NS se a janela ainda for curta.
+ */
+Mm_Slow_Path_Snapshot mm_slow_path_snapshot() {
+    pthread_once(&mm_stats_once, mm_stats_init_key);
+
+    Mm_Stats_Shard sum;
+    mm_stats_sum(&sum);
+    double ns_per_tick = mm_stats_ns_per_tick();
+
+    Mm_Slow_Path_Snapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    pthread_mutex_lock(&mm_stats_lock);
+    for (int p = 0; p < MM_SLOW_PATH_COUNT; p++) {
+        snapshot.paths[p].events = mm_stats_gauge(sum.slow_events[p] - mm_slow_base_events[p]);
+        snapshot.paths[p].depth = mm_stats_gauge(sum.slow_depth[p] - mm_slow_base_depth[p]);
+        snapshot.paths[p].total_ns = (u64)((double)mm_stats_gauge(sum.slow_ticks[p] - mm_slow_base_ticks[p]) * ns_per_tick);
+    }
+    snapshot.elapsed_ns = mm_stats_nanos() - mm_slow_reset_ns;
+    pthread_mutex_unlock(&mm_stats_lock);
+
+    return snapshot;
+}
+
+const char *mm_slow_path_name(Mm_Slow_Path path) {
+    switch (path) {
+        case MM_SLOW_POOL_REFILL:    return "pool_refill";
+        case MM_SLOW_RESERVE_COMMIT: return "reserve_commit";
+        case MM_SLOW_SPLIT:          return "split";
+        case MM_SLOW_MERGE:          return "merge";
+        case MM_SLOW_HUGE_MMAP:      return "huge_mmap";
+        case MM_SLOW_HUGE_MUNMAP:    return "huge_munmap";
+        default:                     return "unknown";
+    }
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+static void mm_stats_init_key() {
+    pthread_key_create(&mm_stats_key, mm_stats_detach);
+
+    mm_clock_origin_ns = mm_stats_nanos();
+    mm_clock_origin_ticks = mm_stats_ticks();
+    mm_slow_reset_ns = mm_clock_origin_ns;
+}
+
+// Todos os contadores do shard são i64 antes de 'shared': soma campo a campo
+static void mm_stats_sum(Mm_Stats_Shard *sum) {
+    memset(sum, 0, sizeof(*sum));
+    size_t counters = offsetof(Mm_Stats_Shard, shared) / sizeof(i64);
+
+    u32 count = __atomic_load_n(&mm_stats_shard_count, __ATOMIC_ACQUIRE);
+    for (u32 s = 0; s <= count; s++) {
+        i64 *src = (i64*)((s < count) ? &mm_stats_shards[s] : &mm_stats_overflow);
+        i64 *dst = (i64*)sum;
+        for (size_t c = 0; c < counters; c++) {
+            dst[c] += __atomic_load_n(&src[c], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static u64 mm_stats_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double mm_stats_ns_per_tick() {
+#if MM_SLOW_PATH_TIMING && MM_STATS_HAS_TSC
+    u64 now_ns = mm_stats_nanos();
+    while (now_ns - mm_clock_origin_ns < MM_STATS_CALIBRATION_NS) now_ns = mm_stats_nanos();
+
+    u64 now_ticks = mm_stats_ticks();
+    return (double)(now_ns - mm_clock_origin_ns) / (double)(now_ticks - mm_clock_origin_ticks);
+#else
+    return 1.0;
+#endif
+}
+
+/*
+Fim da thread: o shard volta para a lista de livres com os contadores intactos.
+Frees feitos depois disso por outros destrutores da thread vão para o shard de transbordo.
+ */
+static void mm_stats_detach(void *shard) {
+    u32 index = (u32)((Mm_Stats_Shard*)shard - mm_stats_shards);
+
+    pthread_mutex_lock(&mm_stats_lock);
+    mm_stats_free_shards[mm_stats_free_count++] = index;
+    pthread_mutex_unlock(&mm_stats_lock);
+
+    mm_stats_tls = &mm_stats_overflow;
+}
+
+// Soma de deltas de shards diferentes pode ficar negativa por um instante (free lido antes do alloc)
+static u64 mm_stats_gauge(i64 value) {
+    return (value > 0) ? (u64)value : 0;
+}
+
+static const char *mm_stats_owner_name(u32 owner) {
+    switch (owner) {
+        case OWNER_NONE:  return "none";
+        case OWNER_ARENA: return "arena";
+        case OWNER_POOL:  return "pool";
+        case OWNER_HEAP:  return "heap";
+        default:          return "debug";
+    }
+}
@@ -0,0 +1,198 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdbool.h>
+#include <sys/sysinfo.h>
+
+#include "../include/percpu_cache.h"
+#include "../include/backend_manager.h"
+#include "../include/pool.h"
+
+#if defined(__linux__) && defined(__x86_64__) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define PERCPU_CACHE_HAS_RSEQ 1
+#else
+#define PERCPU_CACHE_HAS_RSEQ 0
+#endif
+
+
+// ==========================
+//  ESTRUTURAS PRINCIPAIS
+// ==========================
+
+// 'count' precisa ficar no offset 0 e 'slots' logo em seguida (layout usado pelo assembly)
+typedef struct Percpu_Class {
+    u64 count;
+    void *slots[PERCPU_CACHE_SLOTS];
+} Percpu_Class;
+
+typedef struct Percpu_Cache {
+    Percpu_Class classes[PERCPU_CACHE_MAX_CLASSES];
+} Percpu_Cache;
+
+static u8 *percpu_caches = NULL; // Array [num_cpus] de caches, cada um com 'num_classes' classes
+static size_t percpu_stride = 0; // Bytes entre o cache de uma CPU e o da próxima
+static bool percpu_enabled = false;
+
+
+// ==========================
+//  SEÇÕES CRÍTICAS (rseq)
+// ==========================
+
+#if PERCPU_CACHE_HAS_RSEQ
+
+#define RSEQ_SIGNATURE 0x53053053 // Mesma assinatura registrada pela glibc no x86_64
+#define RSEQ_STR(x) #x
+#define RSEQ_XSTR(x) RSEQ_STR(x)
+
+static inline struct rseq *percpu_get_rseq() {
+    return (struct rseq*)((u8*)__builtin_thread_pointer() + __rseq_offset);
+}
+
+/*
+Layout de cada seção:
+  3: descritor struct rseq_cs (start_ip = 1, post_commit = 2, abort_ip = 4)
+  5: registra o descritor em rseq->rseq_cs
+  1: lê cpu_id, calcula o endereço da classe desta CPU, lê count
+     ...
+     store de commit (última instrução)
+  2: fim
+  4: handler de abort (precedido pela assinatura), recomeça em 5
+ */
+static inline void *rseq_pop(u8 *class_base) {
+    void *result;
+
+    __asm__ __volatile__ (
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"
+        ".quad 1f, (2f - 1f), 4f\n\t"
+        ".popsection\n\t"
+        "5:\n\t"
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, 8(%[rs])\n\t"
+        "1:\n\t"
+        "xorl %k[result], %k[result]\n\t"
+        "movl 4(%[rs]), %%eax\n\t"
+        "imulq %[stride], %%rax\n\t"
+        "addq %[base], %%rax\n\t"
+        "movq (%%rax), %%rcx\n\t"
+        "testq %%rcx, %%rcx\n\t"
+        "jz 2f\n\t"
+        "movq (%%rax,%%rcx,8), %[result]\n\t"   // slots[count - 1]
+        "decq %%rcx\n\t"
+        "movq %%rcx, (%%rax)\n\t"               // commit: count--
+        "2:\n\t"
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".long " RSEQ_XSTR(RSEQ_SIGNATURE) "\n\t"
+        "4:\n\t"
+        "jmp 5b\n\t"
+        ".popsection\n\t"
+        : [result] "=&r" (result)
+        : [rs] "r" (percpu_get_rseq()), [base] "r" (class_base), [stride] "r" (percpu_stride)
+        : "rax", "rcx", "memory", "cc"
+    );
+
+    return result;
+}
+
+static inline bool rseq_push(u8 *class_base, void *ptr) {
+    u64 pushed;
+
+    __asm__ __volatile__ (
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"
+        ".quad 1f, (2f - 1f), 4f\n\t"
+        ".popsection\n\t"
+        "5:\n\t"
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, 8(%[rs])\n\t"
+        "1:\n\t"
+        "xorl %k[pushed], %k[pushed]\n\t"
+        "movl 4(%[rs]), %%eax\n\t"
+        "imulq %[stride], %%rax\n\t"
+        "addq %[base], %%rax\n\t"
+        "movq (%%rax), %%rcx\n\t"
+        "cmpq %[cap], %%rcx\n\t"
+        "jae 2f\n\t"
+        "incq %%rcx\n\t"
+        "movq %[ptr], (%%rax,%%rcx,8)\n\t"      // slots[count] (ainda invisível: count não mudou)
+        "movl $1, %k[pushed]\n\t"
+        "movq %%rcx, (%%rax)\n\t"               // commit: count++
+        "2:\n\t"
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".long " RSEQ_XSTR(RSEQ_SIGNATURE) "\n\t"
+        "4:\n\t"
+        "jmp 5b\n\t"
+        ".popsection\n\t"
+        : [pushed] "=&r" (pushed)
+        : [rs] "r" (percpu_get_rseq()), [base] "r" (class_base), [stride] "r" (percpu_stride),
+          [ptr] "r" (ptr), [cap] "i" (PERCPU_CACHE_SLOTS)
+        : "rax", "rcx", "memory", "cc"
+    );
+
+    return pushed != 0;
+}
+
+#endif
+
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+/*
+Aloca os caches (um por CPU possível) e ativa o front-end. Retorna false sem rseq.
+Deve ser chamado antes das threads começarem a alocar.
+ */
+bool percpu_cache_init(u32 num_classes) {
+#if PERCPU_CACHE_HAS_RSEQ
+    if (percpu_enabled) return true;
+    if (num_classes == 0 || num_classes > PERCPU_CACHE_MAX_CLASSES) return false;
+
+    // glibc registra o rseq de cada thread; tamanho 0 = kernel sem rseq ou registro desativado
+    if (__rseq_size == 0 || (int)percpu_get_rseq()->cpu_id < 0) return false;
+
+    int num_cpus = get_nprocs_conf();
+    if (num_cpus < 1) return false;
+
+    percpu_stride = align_size(sizeof(Percpu_Class) * num_classes, CACHE_LINE_SIZE);
+    percpu_caches = (u8*)backend_alloc(percpu_stride * num_cpus, OWNER_POOL);
+    if (percpu_caches == NULL) return false;
+
+    for (size_t i = 0; i < percpu_stride * num_cpus; i++) {
+        percpu_caches[i] = 0;
+    }
+
+    __atomic_store_n(&percpu_enabled, true, __ATOMIC_RELEASE);
+    return true;
+#else
+    (void)num_classes;
+    return false;
+#endif
+}
+
+bool percpu_cache_is_enabled() {
+    return __atomic_load_n(&percpu_enabled, __ATOMIC_ACQUIRE);
+}
+
+void *percpu_cache_pop(u32 size_class) {
+#if PERCPU_CACHE_HAS_RSEQ
+    return rseq_pop(percpu_caches + size_class * sizeof(Percpu_Class));
+#else
+    (void)size_class;
+    return NULL;
+#endif
+}
+
+bool percpu_cache_push(u32 size_class, void *ptr) {
+#if PERCPU_CACHE_HAS_RSEQ
+    return rseq_push(percpu_caches + size_class * sizeof(Percpu_Class), ptr);
+#else
+    (void)size_class;
+    (void)ptr;
+    return false;
+#endif
+}
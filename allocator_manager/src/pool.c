@@ -1,11 +1,21 @@
+#define _GNU_SOURCE // sched_getcpu()
 #include <sys/mman.h>
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include "../include/pool.h"
+#include "../include/percpu_cache.h"
+#include "../include/trace.h"
+#include "../include/mm_stats.h"
+#include "../include/heap_profiler.h"
+#include "../include/guarded_pool.h"
+#include "../include/mem.h"
+#include "../include/probes.h"
 #include "../include/utilities.h"
 
 
@@ -32,6 +42,9 @@ typedef struct Pool_Chunk {
     size_t block_size;
     size_t capacity; // Quantidade total de blocos
     size_t used_count;
+    size_t link_offset; // Offset do Pool_Block dentro do bloco (ver Object Cache)
+    size_t color;       // Deslocamento de data_start (cache coloring)
+    u8 *clean_start;    // Blocos a partir daqui nunca foram entregues e estão zerados (exceto o link da free_list)
 
     struct Pool *parent_pool;
 } Pool_Chunk;
@@ -45,26 +58,100 @@ typedef struct Pool {
 
     u16 alignment;
     u16 chunk_order;
+    u16 next_color; // Próximo deslocamento de cor a ser usado por um chunk novo
+    i16 size_class;   // Índice em generic_pools/long_lived_pools, -1 para as demais pools
+    i16 percpu_class; // Classe no cache por CPU, -1 se a pool não usa o cache
+    Pool_Lifetime lifetime;
+
+    /*
+    Object Cache (slab): objetos livres permanecem construídos. O ponteiro 'next' da free_list
+    fica após o objeto (link_offset), para não sobrescrever o estado construído.
+    ctor roda ao fatiar um chunk, dtor quando o chunk sai da pool.
+     */
+    Object_Ctor ctor;
+    Object_Dtor dtor;
+    size_t object_size;
+    size_t link_offset;
+
+    // Reserva de chunks vazios (histerese), evita devolver/pedir o mesmo chunk ao backend em loop
+    Pool_Chunk *empty_chunks;
+    u16 empty_count;
+    u16 max_empty_chunks;
+
+    // Pools customizadas: compartilhadas por todos os pool_create() de mesmo block_size
+    u32 ref_count;
+    bool is_custom;
+    struct Pool *next_free; // Próximo slot livre (somente enquanto o slot está livre)
 
     Allocator *parent_allocator;
 } Pool;
 
+/*
+Página extra da root_page, guarda os headers das pools customizadas.
+Novas páginas são pedidas ao backend sob demanda, sem limite fixo.
+ */
+typedef struct Custom_Pool_Page {
+    struct Custom_Pool_Page *next;
+    size_t count;
+    Pool pools[];
+} Custom_Pool_Page;
+
+#define CUSTOM_POOLS_PER_PAGE ((PAGE_SIZE - sizeof(Custom_Pool_Page)) / sizeof(Pool))
+
+/*
+Arena (modelo jemalloc): cada Allocator tem suas pools, chunks e reservas, protegidos por 'lock'.
+Threads são associadas a uma arena na primeira alocação; o free segue Pool_Chunk->parent_pool.
+ */
 typedef struct Allocator {
+    pthread_mutex_t lock;
+    u32 arena_index;
     size_t total_memory;
     struct Pool generic_pools[MAX_GENERIC_POOLS]; 
-    struct Pool custom_pools[MAX_CUSTOM_POOLS];
+    struct Pool long_lived_pools[MAX_GENERIC_POOLS]; // palloc_hint(LIFETIME_LONG): chunks separados dos blocos curtos
+
+    // Tabela dinâmica de pools customizadas + índice por block_size (block_size / 8)
+    Custom_Pool_Page *custom_pool_pages;
+    Pool *free_custom_pools;
+    Pool *custom_pool_index[CUSTOM_POOL_INDEX_SIZE];
+
+    // Reserva global de chunks vazios, indexada por chunk_order (compartilhada entre as pools)
+    Pool_Chunk *empty_chunks[MAX_BIN_ORDER+1];
+    u16 empty_count[MAX_BIN_ORDER+1];
+    u16 max_global_empty_chunks;
+
+    Pool_Reserve_Stats reserve_stats;
 } Allocator;
 
 
 // DECLARAÇÕES
-Pool_Chunk *get_chunk(size_t size);
+Pool_Chunk *get_chunk(size_t size, bool *zeroed);
 Pool_Block *slice_pool_blocks(Pool_Chunk *chunk);
 void pool_get_memory(Pool *pool);
+void pool_try_release_chunk(Pool_Chunk *chunk);
+void pool_init(Pool *pool, Allocator *allocator, size_t block_size, size_t alignment);
+Pool *allocator_get_custom_slot(Allocator *allocator);
+bool pool_carve_chunk(Pool *pool, Pool_Chunk *chunk, bool zeroed);
+void *pool_take_block(Pool *pool, bool *clean);
+void pool_destruct_chunk(Pool *pool, Pool_Chunk *chunk);
+void pool_insert_chunk(Pool *pool, Pool_Chunk *chunk);
+void pool_requeue_chunk(Pool *pool, Pool_Chunk *chunk);
+void pool_release_chunk(Pool *pool, Pool_Chunk *chunk);
+void allocator_release_chunk(Allocator *allocator, Pool_Chunk *chunk);
 u16 calculate_optimal_chunk_order(size_t block_size);
 static inline int get_pool_index_from_size(size_t size);
-void ensure_allocator_initialized();
-
-static Allocator *global_allocator = NULL;
+static inline size_t get_pool_size_from_index(int index);
+static inline void pool_stats_alloc(int index, size_t size);
+void pool_chunk_page_usage(Pool_Chunk *chunk, u32 *live_bytes, size_t max_pages);
+void pool_add_page_bytes(u32 *live_bytes, size_t max_pages, size_t first_page, Pool_Chunk *chunk, u8 *start, size_t length, i64 sign);
+Allocator *ensure_allocator_initialized();
+
+static Allocator *allocator_arenas[MAX_ALLOCATOR_ARENAS];
+static u32 arena_count = 0; // 0 = ainda não configurado (usa o número de CPUs)
+static u32 next_arena = 0;
+static Arena_Policy arena_policy = ARENA_ROUND_ROBIN;
+static pthread_mutex_t arenas_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local Allocator *thread_allocator = NULL;
+static bool cache_coloring_enabled = true;
 
 /* 
 ==============================
@@ -73,81 +160,158 @@ static Allocator *global_allocator = NULL;
 */
 
 Allocator *allocator_create() {
-    void *root_base = backend_alloc(PAGE_SIZE, OWNER_POOL);
+    // Os chunks das pools saem da reserva: o maior bloco do backend precisa comportar as classes médias
+    size_t max_block_size = REQUEST_SIZE_FROM_ORDER(backend_max_order());
+    if (max_block_size < pool_min_chunk_size()) {
+        fprintf(stderr, "Error: Backend blocks of order %u (%zu bytes) cannot hold a pool chunk of %zu bytes [allocator_create()]\n",
+                backend_max_order(), max_block_size, pool_min_chunk_size());
+        return NULL;
+    }
+
+    void *root_base = backend_alloc(sizeof(Allocator), OWNER_POOL);
     if (!root_base) return NULL;
     Allocator *allocator = (Allocator*)root_base;
+    pthread_mutex_init(&allocator->lock, NULL);
+    allocator->arena_index = 0;
     allocator->total_memory = 0;
 
-    // Init generic pools
-    size_t pool_block_size = 8;
-    size_t pool_alignment = 8;
+    for (size_t i = 0; i <= MAX_BIN_ORDER; i++) {
+        allocator->empty_chunks[i] = NULL;
+        allocator->empty_count[i] = 0;
+    }
+    allocator->max_global_empty_chunks = GLOBAL_EMPTY_CHUNK_RESERVE;
+    allocator->reserve_stats = (Pool_Reserve_Stats){0};
 
+    // Init generic pools (pequenas e médias), uma série por tempo de vida
     for (size_t i = 0; i < MAX_GENERIC_POOLS; i++) {
-        Pool *current_pool = &allocator->generic_pools[i];
-        if (i != 0) pool_alignment = DEFAULT_ALIGNMENT;
-        current_pool->alignment = pool_alignment;
-        current_pool->block_size = pool_block_size;
-        current_pool->capacity = 0;
-        current_pool->parent_allocator = allocator;
-        current_pool->head_chunk = NULL;
-        current_pool->active_chunk = NULL;
-        current_pool->chunk_order = calculate_optimal_chunk_order(pool_block_size);
-        pool_block_size *= 2;
-    }
-
-    for (size_t i = 0; i < MAX_CUSTOM_POOLS; i++) {
-        Pool *current_pool = &allocator->custom_pools[i];
-        current_pool->alignment = DEFAULT_ALIGNMENT;
-        current_pool->block_size = 0;
-        current_pool->capacity = 0;
-        current_pool->parent_allocator = allocator;
-        current_pool->head_chunk = NULL;
-        current_pool->active_chunk = NULL;
+        size_t pool_alignment = (i == 0) ? 8 : DEFAULT_ALIGNMENT;
+        size_t pool_block_size = get_pool_size_from_index(i);
+
+        pool_init(&allocator->generic_pools[i], allocator, pool_block_size, pool_alignment);
+        allocator->generic_pools[i].size_class = (i16)i;
+        allocator->generic_pools[i].percpu_class = (i < SMALL_GENERIC_POOLS) ? (i16)i : -1;
+
+        // Blocos longos não passam pelo cache por CPU: voltariam misturados aos curtos pelo palloc
+        pool_init(&allocator->long_lived_pools[i], allocator, pool_block_size, pool_alignment);
+        allocator->long_lived_pools[i].size_class = (i16)i;
+        allocator->long_lived_pools[i].lifetime = LIFETIME_LONG;
+    }
+
+    // Custom pools: páginas alocadas sob demanda em pool_create()
+    allocator->custom_pool_pages = NULL;
+    allocator->free_custom_pools = NULL;
+    for (size_t i = 0; i < CUSTOM_POOL_INDEX_SIZE; i++) {
+        allocator->custom_pool_index[i] = NULL;
     }
 
     return allocator;
 }
 
+void pool_init(Pool *pool, Allocator *allocator, size_t block_size, size_t alignment) {
+    pool->head_chunk = NULL;
+    pool->active_chunk = NULL;
+    pool->capacity = 0;
+    pool->block_size = block_size;
+    pool->alignment = alignment;
+    pool->chunk_order = calculate_optimal_chunk_order(block_size);
+    pool->next_color = 0;
+    pool->size_class = -1;
+    pool->percpu_class = -1;
+    pool->lifetime = LIFETIME_SHORT;
+
+    pool->ctor = NULL;
+    pool->dtor = NULL;
+    pool->object_size = block_size;
+    pool->link_offset = 0;
+
+    pool->empty_chunks = NULL;
+    pool->empty_count = 0;
+    pool->max_empty_chunks = POOL_EMPTY_CHUNK_RESERVE;
+
+    pool->ref_count = 0;
+    pool->is_custom = false;
+    pool->next_free = NULL;
+
+    pool->parent_allocator = allocator;
+}
+
 Pool *pool_create(size_t block_size) {
-    ensure_allocator_initialized();
+    Allocator *allocator = ensure_allocator_initialized();
+    if (allocator == NULL) return NULL;
 
-    if (block_size > MAX_POOL_BLOCK_SIZE) {
-        fprintf(stderr, "Error [%s]: Requested size can't be larger than 512 bytes.\n", __func__);
+    if (block_size > MAX_SMALL_POOL_BLOCK_SIZE) {
+        fprintf(stderr, "Error [%s]: Requested size can't be larger than %d bytes.\n", __func__, MAX_SMALL_POOL_BLOCK_SIZE);
         return NULL;
     }
     
-    // Search for free custom pool
     size_t alignment = (block_size < DEFAULT_ALIGNMENT) ? 8 : DEFAULT_ALIGNMENT;
     size_t align_block_size = align_size(block_size, alignment);
-    size_t chunk_order = calculate_optimal_chunk_order(align_block_size);
-
-    for (size_t i = 0; i < MAX_CUSTOM_POOLS; i++) {
-        if (global_allocator->custom_pools[i].capacity == 0) {
-            // Achou slot livre
-            Pool *pool = &global_allocator->custom_pools[i];
-            
-            pool->parent_allocator = global_allocator; 
-            pool->chunk_order = chunk_order;
-            pool->alignment = alignment;
-            pool->block_size = align_block_size;
-            pool->parent_allocator = global_allocator;
-            pool->capacity = 0;
-            pool_get_memory(pool);
-            return pool;
-        }
+
+    pthread_mutex_lock(&allocator->lock);
+
+    // Pool com o mesmo block_size já existe: compartilha
+    size_t index = align_block_size / 8;
+    Pool *pool = allocator->custom_pool_index[index];
+    if (pool != NULL) {
+        pool->ref_count++;
+        pthread_mutex_unlock(&allocator->lock);
+        return pool;
     }
 
-    fprintf(stderr, "Error [%s]: Out of custom pools!\n", __func__);
-    return NULL;
+    pool = allocator_get_custom_slot(allocator);
+    if (pool == NULL) {
+        pthread_mutex_unlock(&allocator->lock);
+        fprintf(stderr, "Error [%s]: Out of custom pools!\n", __func__);
+        return NULL;
+    }
+
+    pool_init(pool, allocator, align_block_size, alignment);
+    pool->is_custom = true;
+    pool->ref_count = 1;
+    allocator->custom_pool_index[index] = pool;
+
+    pool_get_memory(pool);
+
+    pthread_mutex_unlock(&allocator->lock);
+    return pool;
 }
 
+/*
+Alocação em pool customizada. palloc() usa pool_take_block() direto: as pools genéricas são
+amostradas pelo profiler de heap lá, com o tamanho pedido.
+ */
 void *pool_alloc(Pool *pool) {
+    void *ptr = pool_take_block(pool, NULL);
+    if (heap_profiler_is_enabled() && ptr != NULL) heap_profiler_account(ptr, pool->block_size);
+    return ptr;
+}
+
+/*
+Retira um bloco da pool. Se 'clean' não for NULL, informa se o bloco nunca foi entregue
+e veio zerado do backend (só o link da free_list está escrito).
+ */
+void *pool_take_block(Pool *pool, bool *clean) {
     if (pool == NULL) {
         fprintf(stderr, "Error: Tried to allocate on invalid pool\n");
         return NULL;
     }
+    Allocator *allocator = pool->parent_allocator;
+    pthread_mutex_lock(&allocator->lock);
+
     if (pool->active_chunk == NULL || pool->active_chunk->free_list == NULL) {
-        pool_get_memory(pool);
+        if (pool->active_chunk != NULL && pool->active_chunk->next != NULL) {
+            // Chunk já na lista com blocos livres: todos os que vêm depois do ativo têm (ver pool_requeue_chunk)
+            pool->active_chunk = pool->active_chunk->next;
+        } else {
+            u64 slow_start = mm_stats_ticks();
+            pool_get_memory(pool);
+            mm_stats_slow_path(MM_SLOW_POOL_REFILL, 0, slow_start);
+        }
+
+        if (pool->active_chunk == NULL || pool->active_chunk->free_list == NULL) {
+            pthread_mutex_unlock(&allocator->lock);
+            return NULL;
+        }
     }
 
     Pool_Chunk *selected_chunck = pool->active_chunk;
@@ -155,83 +319,306 @@ void *pool_alloc(Pool *pool) {
     selected_chunck->free_list = block->next;
     selected_chunck->used_count++;
 
-    return (void*)block;
+    /*
+    Os blocos intocados estão no fim da free_list, em ordem de endereço (nunca voltam para ela antes de
+    serem entregues), então são entregues exatamente na ordem de clean_start.
+     */
+    u8 *user_ptr = (u8*)block - pool->link_offset;
+    bool pristine = (user_ptr >= selected_chunck->clean_start);
+    if (pristine) selected_chunck->clean_start = user_ptr + selected_chunck->block_size;
+    if (clean) *clean = pristine;
+
+    pthread_mutex_unlock(&allocator->lock);
+    return (void*)user_ptr;
 }
 
-
 void pool_free(void *ptr) {
+    if (guarded_owns(ptr)) {
+        guarded_free(ptr);
+        return;
+    }
+
     Page_Descriptor *chunk_descriptor = get_descriptor(ptr);
     if (chunk_descriptor == NULL) return;
 
     Pool_Chunk *owner_chunk = (Pool_Chunk*)chunk_descriptor->zone_header;
 
-    size_t chunk_byte_size = (1 << chunk_descriptor->order) * PAGE_SIZE;
+    size_t chunk_byte_size = REQUEST_SIZE_FROM_ORDER(chunk_descriptor->order);
     assert(((ptr > (void*)owner_chunk) && (ptr < (void*)((u8*)owner_chunk + chunk_byte_size)))); // Sanity Check
 
-    Pool_Block *freed_block = (Pool_Block*)ptr; 
+    // O chunk tem ao menos um bloco vivo (ptr), então parent_pool não muda até o lock
+    Pool *parent = owner_chunk->parent_pool;
+
+    heap_profiler_on_free(ptr);
+
+    // Só blocos de palloc (pools genéricas) entram na trace e nas estatísticas por classe
+    if (parent->size_class >= 0) {
+        MM_STATS_ADD(class_frees[parent->size_class], 1);
+        if (trace_is_enabled()) trace_record(TRACE_OP_POOL_FREE, ptr, 0);
+    }
+
+    // Front-end por CPU (só classes pequenas): o bloco continua contado como usado no chunk enquanto estiver no cache
+    if (parent->percpu_class >= 0 && percpu_cache_is_enabled()) {
+        if (percpu_cache_push(parent->percpu_class, ptr)) return;
+    }
+
+    Allocator *allocator = parent->parent_allocator;
+    pthread_mutex_lock(&allocator->lock);
+
+    // Chunk cheio ganhando um bloco livre: volta para a frente da fila de alocação
+    if (owner_chunk->free_list == NULL) {
+        pool_requeue_chunk(parent, owner_chunk);
+    }
+
+    Pool_Block *freed_block = (Pool_Block*)((u8*)ptr + owner_chunk->link_offset); 
     freed_block->next = owner_chunk->free_list;
     owner_chunk->free_list = freed_block;
     owner_chunk->used_count--;
 
     // Verificar se chunk está vazio e devolve ao backend
     if (owner_chunk->used_count == 0) {
-        Pool_Chunk *prev = owner_chunk->prev;
-        Pool_Chunk *next = owner_chunk->next;
-        if (prev == NULL) return;
+        pool_try_release_chunk(owner_chunk);
+    }
 
+    pthread_mutex_unlock(&allocator->lock);
+}
 
-        f32 prev_usage_percentage =  (f32)prev->used_count / (f32)prev->capacity;
-        if (prev_usage_percentage >= CHUNK_USAGE_TRESHOLD) return;
+/*
+Tamanho útil do bloco: block_size do chunk dono, ou só o objeto em Object Caches (o link fica depois dele)
+ */
+size_t pool_usable_size(void *ptr) {
+    if (guarded_owns(ptr)) return guarded_usable_size(ptr);
 
-        prev->next = next;
+    Page_Descriptor *chunk_descriptor = get_descriptor(ptr);
+    if (chunk_descriptor == NULL) return 0;
 
-        if (next != NULL) {
-            next->prev = prev;
-        }
+    Pool_Chunk *owner_chunk = (Pool_Chunk*)chunk_descriptor->zone_header;
+    return owner_chunk->link_offset ? owner_chunk->link_offset : owner_chunk->block_size;
+}
 
-        Pool *parent = owner_chunk->parent_pool;
-        if (parent->active_chunk == owner_chunk) {
-            parent->active_chunk = prev;
-        }
+/*
+Redimensiona um bloco de palloc()/palloc_hint(). Mesmo índice de generic_pools: devolve o próprio ptr.
+Senão move para a classe certa (mesmo tempo de vida), ou para o backend (OWNER_HEAP, liberar com
+backend_free/mem_free) acima de MAX_POOL_BLOCK_SIZE, copiando min(antigo, novo) bytes.
+Blocos do backend que o próprio prealloc devolveu seguem por mem_realloc().
+ */
+void *prealloc(void *ptr, size_t new_size) {
+    if (ptr == NULL) {
+        return (new_size > MAX_POOL_BLOCK_SIZE) ? backend_alloc(new_size, OWNER_HEAP) : palloc(new_size);
+    }
 
-        backend_free(owner_chunk);
+    if (!guarded_owns(ptr)) {
+        Page_Descriptor *descriptor = is_huge_allocation(ptr) ? NULL : get_descriptor(ptr);
+        if (descriptor == NULL || descriptor->owner_id != OWNER_POOL) return mem_realloc(ptr, new_size);
     }
+
+    if (new_size == 0) {
+        pool_free(ptr);
+        return NULL;
+    }
+
+    // Bloco amostrado: sempre sai da região guardada (a classe do palloc decide de novo)
+    if (guarded_owns(ptr)) {
+        void *new_ptr = (new_size > MAX_POOL_BLOCK_SIZE) ? backend_alloc(new_size, OWNER_HEAP) : palloc(new_size);
+        if (new_ptr == NULL) return NULL;
+
+        size_t old_size = guarded_usable_size(ptr);
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+        guarded_free(ptr);
+        return new_ptr;
+    }
+
+    Pool_Chunk *owner_chunk = (Pool_Chunk*)get_descriptor(ptr)->zone_header;
+    Pool *parent = owner_chunk->parent_pool;
+    size_t old_size = pool_usable_size(ptr);
+
+    if (new_size <= MAX_POOL_BLOCK_SIZE) {
+        // Pools customizadas não têm classe: basta caber no bloco
+        bool same_class = (parent->size_class >= 0) ? (get_pool_index_from_size(new_size) == parent->size_class)
+                                                    : (new_size <= old_size);
+        if (same_class) return ptr;
+    }
+
+    void *new_ptr = (new_size > MAX_POOL_BLOCK_SIZE) ? backend_alloc(new_size, OWNER_HEAP)
+                                                     : palloc_hint(new_size, parent->lifetime);
+    if (new_ptr == NULL) return NULL;
+
+    memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+    pool_free(ptr);
+
+    return new_ptr;
+}
+
+/*
+Cabeçalho do chunk + MEDIUM_MIN_BLOCKS_PER_CHUNK blocos da maior classe: allocator_create() recusa
+backends com blocos de ordem máxima menores, senão os chunks das classes médias ficariam sem nenhum bloco.
+ */
+size_t pool_min_chunk_size() {
+    return align_size(sizeof(Pool_Chunk), DEFAULT_ALIGNMENT) + (size_t)MEDIUM_MIN_BLOCKS_PER_CHUNK * MAX_POOL_BLOCK_SIZE;
+}
+
+/*
+Tamanho do bloco que palloc(size) entrega, ou 0 acima de MAX_POOL_BLOCK_SIZE
+ */
+size_t pool_class_size(size_t size) {
+    int index = get_pool_index_from_size(size);
+    return (index < 0) ? 0 : get_pool_size_from_index(index);
 }
 
 void *palloc(size_t size) {
-    ensure_allocator_initialized();
+    Allocator *allocator = ensure_allocator_initialized();
+    if (allocator == NULL) return NULL;
 
     if (size == 0) return NULL;
     if (size > MAX_POOL_BLOCK_SIZE) {
-        fprintf(stderr, "Error: Pool cannot allocate more than 512 bytes\n");
+        fprintf(stderr, "Error: Pool cannot allocate more than %d bytes\n", MAX_POOL_BLOCK_SIZE);
         return NULL;
     }
 
+    if (guarded_should_sample()) {
+        void *guarded = guarded_alloc(size);
+        if (guarded != NULL) return guarded;
+    }
+
+    int index = get_pool_index_from_size(size);
+    void *ptr = NULL;
+
+    if (index < SMALL_GENERIC_POOLS && percpu_cache_is_enabled()) {
+        ptr = percpu_cache_pop(index);
+    }
+
+    if (ptr == NULL) {
+        ptr = pool_take_block(&allocator->generic_pools[index], NULL);
+    }
+
+    if (ptr != NULL) pool_stats_alloc(index, size);
+    if (trace_is_enabled()) trace_record(TRACE_OP_PALLOC, ptr, size);
+    heap_profiler_on_alloc(ptr, size);
+    return ptr;
+}
+
+/*
+palloc() com o tempo de vida esperado do bloco. Blocos LIFETIME_LONG vão para pools próprias:
+um sobrevivente longo não segura um chunk de blocos curtos que já foram liberados.
+ */
+void *palloc_hint(size_t size, Pool_Lifetime lifetime) {
+    if (lifetime != LIFETIME_LONG) return palloc(size);
+
+    Allocator *allocator = ensure_allocator_initialized();
+    if (allocator == NULL) return NULL;
+
+    if (size == 0) return NULL;
+    if (size > MAX_POOL_BLOCK_SIZE) {
+        fprintf(stderr, "Error: Pool cannot allocate more than %d bytes\n", MAX_POOL_BLOCK_SIZE);
+        return NULL;
+    }
+
+    if (guarded_should_sample()) {
+        void *guarded = guarded_alloc(size);
+        if (guarded != NULL) return guarded;
+    }
+
+    int index = get_pool_index_from_size(size);
+    void *ptr = pool_take_block(&allocator->long_lived_pools[index], NULL);
+
+    if (ptr != NULL) pool_stats_alloc(index, size);
+    if (trace_is_enabled()) trace_record(TRACE_OP_PALLOC | TRACE_FLAG_LONG_LIVED, ptr, size);
+    heap_profiler_on_alloc(ptr, size);
+    return ptr;
+}
+
+/*
+palloc() zerado. Blocos intocados de chunks que vieram zerados do backend só têm o link da free_list limpo.
+ */
+void *pcalloc(size_t size) {
+    Allocator *allocator = ensure_allocator_initialized();
+    if (allocator == NULL) return NULL;
+
+    if (size == 0) return NULL;
+    if (size > MAX_POOL_BLOCK_SIZE) {
+        fprintf(stderr, "Error: Pool cannot allocate more than %d bytes\n", MAX_POOL_BLOCK_SIZE);
+        return NULL;
+    }
+
+    if (guarded_should_sample()) {
+        void *guarded = guarded_alloc(size);
+        if (guarded != NULL) return guarded;
+    }
+
     int index = get_pool_index_from_size(size);
+    void *ptr = NULL;
+    bool clean = false;
 
-    Pool *target_pool = &global_allocator->generic_pools[index];
+    if (index < SMALL_GENERIC_POOLS && percpu_cache_is_enabled()) {
+        ptr = percpu_cache_pop(index);
+    }
+
+    if (ptr == NULL) {
+        ptr = pool_take_block(&allocator->generic_pools[index], &clean);
+        if (ptr == NULL) return NULL;
+    }
+
+    if (clean) {
+        ((Pool_Block*)ptr)->next = NULL; // Pools genéricas: link_offset = 0
+    } else {
+        memset(ptr, 0, size);
+    }
 
-    return pool_alloc(target_pool);
+    pool_stats_alloc(index, size);
+    if (trace_is_enabled()) trace_record(TRACE_OP_PALLOC | TRACE_FLAG_ZEROED, ptr, size);
+    heap_profiler_on_alloc(ptr, size);
+    return ptr;
 }
 
 void pool_destroy(Pool *pool) {
     if (pool == NULL) return;
 
+    Allocator *allocator = pool->parent_allocator;
+    pthread_mutex_lock(&allocator->lock);
+
+    // Pool compartilhada: só destrói quando o último usuário chamar pool_destroy()
+    // Object Caches: objetos ainda vivos também passam pelo dtor
+    if (pool->is_custom && --pool->ref_count > 0) {
+        pthread_mutex_unlock(&allocator->lock);
+        return;
+    }
+
     Pool_Chunk *curr = pool->head_chunk;
     
     while (curr != NULL) {
         Pool_Chunk *next_chunk = curr->next;
-        backend_free(curr);
+        allocator_release_chunk(allocator, curr);
+        curr = next_chunk;
+    }
+
+    curr = pool->empty_chunks;
+    while (curr != NULL) {
+        Pool_Chunk *next_chunk = curr->next;
+        allocator_release_chunk(allocator, curr);
         curr = next_chunk;
     }
 
     pool->head_chunk = NULL;
     pool->active_chunk = NULL;
+    pool->empty_chunks = NULL;
+    pool->empty_count = 0;
     
-    pool->capacity = 0;       // Marca o slot como "livre" no array do Allocator
+    pool->capacity = 0;
+
+    // Devolve o slot para a lista de slots livres do Allocator
+    if (pool->is_custom) {
+        if (allocator->custom_pool_index[pool->block_size / 8] == pool) {
+            allocator->custom_pool_index[pool->block_size / 8] = NULL;
+        }
+        pool->next_free = allocator->free_custom_pools;
+        allocator->free_custom_pools = pool;
+    }
+
     pool->block_size = 0;
     pool->chunk_order = 0;
     pool->alignment = 0;
+
+    pthread_mutex_unlock(&allocator->lock);
 }
 
 
@@ -242,14 +629,14 @@ FUNÇÕES AUXILIARES
 */
 
 
-Pool_Chunk *get_chunk(size_t size) {
-    return (Pool_Chunk*)backend_alloc(size, OWNER_POOL);
+Pool_Chunk *get_chunk(size_t size, bool *zeroed) {
+    return (Pool_Chunk*)backend_alloc_fresh(size, OWNER_POOL, zeroed);
 }
 
 Pool_Block *slice_pool_blocks(Pool_Chunk *chunk) {
     assert(chunk != NULL && "Invalid chunk pointer passed as argument");
 
-    u8 *curr_ptr = chunk->data_start;
+    u8 *curr_ptr = (u8*)chunk->data_start + chunk->link_offset;
     Pool_Block *fl_head = (Pool_Block*)curr_ptr;
     
     for (size_t i = 0; i < chunk->capacity - 1; i++) {
@@ -268,29 +655,143 @@ Pool_Block *slice_pool_blocks(Pool_Chunk *chunk) {
 }
 
 void pool_get_memory(Pool *pool) {
-    Pool_Chunk *new_chunk = get_chunk(REQUEST_SIZE_FROM_ORDER(pool->chunk_order));
-    
-    if (new_chunk == NULL) {
-        fprintf(stderr, "Error: Could not allocate chunk\n");
+    Allocator *allocator = pool->parent_allocator;
+    Pool_Chunk *new_chunk = NULL;
+    bool zeroed = false; // Chunks das reservas já foram usados
+
+    // 1. Reserva da própria pool: o chunk já está fatiado com o block_size correto
+    if (pool->empty_chunks != NULL) {
+        new_chunk = pool->empty_chunks;
+        pool->empty_chunks = new_chunk->next;
+        pool->empty_count--;
+        allocator->reserve_stats.pool_reserve_hits++;
+
+        pool->capacity += new_chunk->capacity;
+        pool_insert_chunk(pool, new_chunk);
+        MM_PROBE4(pool_refill, pool->chunk_order, REQUEST_SIZE_FROM_ORDER(pool->chunk_order), OWNER_POOL, pool->block_size);
+        return;
+    }
+
+    // 2. Reserva global: chunk de mesma ordem, mas precisa ser re-fatiado
+    if (allocator->empty_chunks[pool->chunk_order] != NULL) {
+        new_chunk = allocator->empty_chunks[pool->chunk_order];
+        allocator->empty_chunks[pool->chunk_order] = new_chunk->next;
+        allocator->empty_count[pool->chunk_order]--;
+        allocator->reserve_stats.global_reserve_hits++;
+    } else {
+        // 3. Backend
+        new_chunk = get_chunk(REQUEST_SIZE_FROM_ORDER(pool->chunk_order), &zeroed);
+        if (new_chunk == NULL) {
+            fprintf(stderr, "Error: Could not allocate chunk\n");
+            return;
+        }
+        allocator->reserve_stats.backend_refills++;
+        MM_STATS_ADD(pool_refills, 1);
+    }
+
+    if (!pool_carve_chunk(pool, new_chunk, zeroed)) {
+        backend_free(new_chunk);
         return;
     }
+    pool_insert_chunk(pool, new_chunk);
+    MM_PROBE4(pool_refill, pool->chunk_order, REQUEST_SIZE_FROM_ORDER(pool->chunk_order), OWNER_POOL, pool->block_size);
+}
+
+/*
+Chamado com o lock da arena. Decide se um chunk que acabou de ficar vazio sai da lista da pool.
+ */
+void pool_try_release_chunk(Pool_Chunk *chunk) {
+    Pool_Chunk *prev = chunk->prev;
+    Pool_Chunk *next = chunk->next;
+    if (prev == NULL) return;
+
+    f32 prev_usage_percentage =  (f32)prev->used_count / (f32)prev->capacity;
+    if (prev_usage_percentage >= CHUNK_USAGE_TRESHOLD) return;
+
+    prev->next = next;
+
+    if (next != NULL) {
+        next->prev = prev;
+    }
 
-    Page_Descriptor *chunk_desc = get_descriptor(new_chunk);
+    Pool *parent = chunk->parent_pool;
+    if (parent->active_chunk == chunk) {
+        parent->active_chunk = prev;
+    }
+
+    pool_release_chunk(parent, chunk);
+}
 
+/*
+Fatia o chunk com o block_size da pool. Retorna false se nenhum bloco cabe (slice_pool_blocks() exige ao menos um).
+ */
+bool pool_carve_chunk(Pool *pool, Pool_Chunk *chunk, bool zeroed) {
+    Page_Descriptor *chunk_desc = get_descriptor(chunk);
+
+    size_t chunk_byte_size = REQUEST_SIZE_FROM_ORDER(chunk_desc->order);
     size_t padding = align_size(sizeof(Pool_Chunk), DEFAULT_ALIGNMENT);
-    size_t chunk_capacity = (((1 << chunk_desc->order) * PAGE_SIZE) - padding) / pool->block_size;
+    size_t chunk_capacity = (chunk_byte_size > padding) ? (chunk_byte_size - padding) / pool->block_size : 0;
+    if (chunk_capacity == 0) {
+        fprintf(stderr, "Error: Chunk of %zu bytes cannot hold a block of %zu bytes [pool_carve_chunk()]\n",
+                chunk_byte_size, pool->block_size);
+        return false;
+    }
     pool->capacity += chunk_capacity;
+
+    /*
+    Cache coloring: todo chunk começa alinhado pela ordem do buddy, então o primeiro bloco de cada chunk
+    cairia no mesmo set da cache. A sobra do final do chunk é usada para deslocar data_start, 
+    rotacionando entre chunks. A quantidade de blocos não muda.
+     */
+    size_t tail_space = chunk_byte_size - padding - (chunk_capacity * pool->block_size);
+    size_t color = 0;
+
+    if (cache_coloring_enabled) {
+        size_t color_step = (tail_space >= CACHE_LINE_SIZE) ? CACHE_LINE_SIZE : pool->alignment;
+
+        color = pool->next_color;
+        if (color > tail_space) color = 0;
+        pool->next_color = (color + color_step > tail_space) ? 0 : (u16)(color + color_step);
+    }
     
-    new_chunk->block_size = pool->block_size;
-    new_chunk->capacity = chunk_capacity;
-    new_chunk->used_count = 0;
-    new_chunk->data_start = (void*)((u8*)new_chunk + padding);
-    new_chunk->parent_pool = pool;
+    chunk->block_size = pool->block_size;
+    chunk->capacity = chunk_capacity;
+    chunk->used_count = 0;
+    chunk->link_offset = pool->link_offset;
+    chunk->color = color;
+    chunk->data_start = (void*)((u8*)chunk + padding + color);
+    chunk->parent_pool = pool;
+
+    chunk->free_list = slice_pool_blocks(chunk);
+
+    // Chunk zerado e sem ctor: todos os blocos estão limpos; senão nenhum
+    u8 *data_end = (u8*)chunk->data_start + (chunk->capacity * chunk->block_size);
+    chunk->clean_start = (zeroed && pool->ctor == NULL) ? (u8*)chunk->data_start : data_end;
+
+    if (pool->ctor != NULL) {
+        u8 *obj = chunk->data_start;
+        for (size_t i = 0; i < chunk->capacity; i++) {
+            pool->ctor(obj);
+            obj += chunk->block_size;
+        }
+    }
+
+    return true;
+}
+
+void pool_destruct_chunk(Pool *pool, Pool_Chunk *chunk) {
+    if (pool == NULL || pool->dtor == NULL) return;
 
-    new_chunk->free_list = slice_pool_blocks(new_chunk);
+    u8 *obj = chunk->data_start;
+    for (size_t i = 0; i < chunk->capacity; i++) {
+        pool->dtor(obj);
+        obj += chunk->block_size;
+    }
+}
 
-    // Inserir novo chunk na pool
+void pool_insert_chunk(Pool *pool, Pool_Chunk *new_chunk) {
     Pool_Chunk *active = pool->active_chunk;
+    if (pool->size_class >= 0) MM_STATS_ADD(class_chunks[pool->size_class], 1);
 
     if (active == NULL) {
         new_chunk->next = NULL;
@@ -311,6 +812,75 @@ void pool_get_memory(Pool *pool) {
     pool->active_chunk = new_chunk;
 }
 
+/*
+A lista mantém: chunks antes do ativo estão cheios, chunks depois dele têm blocos livres.
+Um chunk cheio que recebe um free está antes do ativo (ou é o próprio): vai para logo depois do ativo,
+senão seus blocos nunca seriam reusados e a pool pediria chunks novos ao backend indefinidamente.
+ */
+void pool_requeue_chunk(Pool *pool, Pool_Chunk *chunk) {
+    Pool_Chunk *active = pool->active_chunk;
+    if (active == NULL || chunk == active) return;
+
+    // Desliga da posição atual
+    if (chunk->prev) {
+        chunk->prev->next = chunk->next;
+    } else {
+        pool->head_chunk = chunk->next;
+    }
+    if (chunk->next) {
+        chunk->next->prev = chunk->prev;
+    }
+
+    // Religa depois do ativo
+    chunk->prev = active;
+    chunk->next = active->next;
+    if (active->next) {
+        active->next->prev = chunk;
+    }
+    active->next = chunk;
+}
+
+/*
+Chunk vazio (já removido da lista da pool) sai da pool.
+Destino, em ordem: reserva da pool -> reserva global -> backend
+ */
+void pool_release_chunk(Pool *pool, Pool_Chunk *chunk) {
+    MM_PROBE4(pool_chunk_release, pool->chunk_order, REQUEST_SIZE_FROM_ORDER(pool->chunk_order), OWNER_POOL, pool->block_size);
+    pool->capacity -= chunk->capacity;
+    if (pool->size_class >= 0) MM_STATS_ADD(class_chunks[pool->size_class], -1);
+
+    if (pool->empty_count < pool->max_empty_chunks) {
+        chunk->next = pool->empty_chunks;
+        chunk->prev = NULL;
+        pool->empty_chunks = chunk;
+        pool->empty_count++;
+        pool->parent_allocator->reserve_stats.chunks_retained++;
+        return;
+    }
+
+    allocator_release_chunk(pool->parent_allocator, chunk);
+}
+
+void allocator_release_chunk(Allocator *allocator, Pool_Chunk *chunk) {
+    u8 order = get_descriptor(chunk)->order;
+
+    // Saindo da pool: objetos do Object Cache voltam ao estado não-construído
+    pool_destruct_chunk(chunk->parent_pool, chunk);
+
+    if (allocator->empty_count[order] < allocator->max_global_empty_chunks) {
+        chunk->next = allocator->empty_chunks[order];
+        chunk->prev = NULL;
+        chunk->parent_pool = NULL;
+        allocator->empty_chunks[order] = chunk;
+        allocator->empty_count[order]++;
+        allocator->reserve_stats.chunks_retained++;
+        return;
+    }
+
+    allocator->reserve_stats.chunks_released++;
+    backend_free(chunk);
+}
+
 u16 calculate_optimal_chunk_order(size_t block_size) {
     size_t header_size = sizeof(Pool_Chunk);
     size_t target_count = 128; 
@@ -319,17 +889,94 @@ u16 calculate_optimal_chunk_order(size_t block_size) {
     if (ideal_size < 16384) ideal_size = 16384; // Tamanho mínimo da Pool é de 16KB
     size_t order = get_order(ideal_size);
 
-    if (order > MAX_BIN_ORDER) {
-        order = MAX_BIN_ORDER;
+    size_t max_order = MAX_BIN_ORDER;
+
+    // Backend configurado com ordem máxima menor: o chunk ainda precisa vir da reserva (zone_header)
+    if (max_order > backend_max_order()) {
+        max_order = backend_max_order();
+    }
+
+    if (order > max_order) {
+        order = max_order;
+    }
+
+    if (block_size <= MAX_SMALL_POOL_BLOCK_SIZE) return (u16)order;
+
+    /*
+    Blocos médios: a sobra no fim do chunk pode passar de 10%. Entre as ordens que comportam
+    MEDIUM_MIN_BLOCKS_PER_CHUNK blocos, escolhe a de menor sobra proporcional (na dúvida, a maior).
+     */
+    size_t padding = align_size(header_size, DEFAULT_ALIGNMENT);
+    size_t best_order = order;
+    size_t best_waste = (REQUEST_SIZE_FROM_ORDER(order) - padding) % block_size;
+
+    for (size_t k = order; k-- > 0;) {
+        size_t chunk_size = REQUEST_SIZE_FROM_ORDER(k);
+        if (chunk_size < padding + (block_size * MEDIUM_MIN_BLOCKS_PER_CHUNK)) break;
+
+        size_t waste = (chunk_size - padding) % block_size;
+        if (waste * REQUEST_SIZE_FROM_ORDER(best_order) < best_waste * chunk_size) {
+            best_order = k;
+            best_waste = waste;
+        }
     }
 
-    return (u16)order;
+    return (u16)best_order;
 }
 
 static inline int get_pool_index_from_size(size_t size) {
-    if (size > 512) return -1;
+    if (size > MAX_POOL_BLOCK_SIZE) return -1;
     if (size < 8) return 0;
-    return fast_log2(round_up_pow2(size)) - 3;
+    if (size <= MAX_SMALL_POOL_BLOCK_SIZE) return fast_log2(round_up_pow2(size)) - 3;
+
+    // Classes médias: 2^g < size <= 2^(g+1), dividido em MEDIUM_CLASSES_PER_DOUBLING passos iguais
+    u32 group = fast_log2((u32)size - 1);
+    size_t base = (size_t)1 << group;
+    size_t step = base / MEDIUM_CLASSES_PER_DOUBLING;
+    size_t slot = (size - base + step - 1) / step;
+
+    return SMALL_GENERIC_POOLS + (group - fast_log2(MAX_SMALL_POOL_BLOCK_SIZE)) * MEDIUM_CLASSES_PER_DOUBLING + (slot - 1);
+}
+
+static inline size_t get_pool_size_from_index(int index) {
+    if (index < SMALL_GENERIC_POOLS) return (size_t)8 << index;
+
+    int medium = index - SMALL_GENERIC_POOLS;
+    size_t base = (size_t)MAX_SMALL_POOL_BLOCK_SIZE << (medium / MEDIUM_CLASSES_PER_DOUBLING);
+    return base + (base / MEDIUM_CLASSES_PER_DOUBLING) * (medium % MEDIUM_CLASSES_PER_DOUBLING + 1);
+}
+
+// Alocação de palloc nas estatísticas da classe: um shard para os dois contadores
+static inline void pool_stats_alloc(int index, size_t size) {
+    Mm_Stats_Shard *shard = mm_stats_shard();
+    mm_stats_add(shard, &shard->class_allocs[index], 1);
+    mm_stats_add(shard, &shard->class_requested[index], (i64)size);
+}
+
+/*
+Retorna um slot livre para uma pool customizada.
+Reaproveita slots de pools destruídas, ou pede uma nova página ao backend.
+ */
+Pool *allocator_get_custom_slot(Allocator *allocator) {
+    if (allocator->free_custom_pools != NULL) {
+        Pool *pool = allocator->free_custom_pools;
+        allocator->free_custom_pools = pool->next_free;
+        return pool;
+    }
+
+    Custom_Pool_Page *page = allocator->custom_pool_pages;
+
+    if (page == NULL || page->count == CUSTOM_POOLS_PER_PAGE) {
+        Custom_Pool_Page *new_page = (Custom_Pool_Page*)backend_alloc(PAGE_SIZE, OWNER_POOL);
+        if (new_page == NULL) return NULL;
+
+        new_page->count = 0;
+        new_page->next = page;
+        allocator->custom_pool_pages = new_page;
+        page = new_page;
+    }
+
+    return &page->pools[page->count++];
 }
 
 int get_pool_index(Pool *p) {
@@ -337,25 +984,402 @@ int get_pool_index(Pool *p) {
 
     Allocator *alloc = p->parent_allocator;
 
-    Pool *start = alloc->custom_pools;            
-    Pool *end   = start + MAX_CUSTOM_POOLS;      
+    if (p->is_custom) {
+        // Páginas ficam em ordem inversa de criação: conta os slots das páginas mais antigas
+        size_t slots_before = 0;
+        int index = -1;
+
+        for (Custom_Pool_Page *page = alloc->custom_pool_pages; page != NULL; page = page->next) {
+            if (p >= page->pools && p < page->pools + page->count) {
+                index = (int)(p - page->pools);
+                continue;
+            }
+            if (index >= 0) slots_before += CUSTOM_POOLS_PER_PAGE;
+        }
 
-    if (p >= start && p < end) {
-        return (int)(p - start);
+        return (index >= 0) ? (int)(slots_before + index) : -1;
     }
 
     Pool *gen_start = alloc->generic_pools;
     Pool *gen_end   = gen_start + MAX_GENERIC_POOLS;
+    Pool *long_start = alloc->long_lived_pools;
+    Pool *long_end   = long_start + MAX_GENERIC_POOLS;
 
-    if (p >= gen_start && p < gen_end) {
+    if ((p >= gen_start && p < gen_end) || (p >= long_start && p < long_end)) {
         return -2; 
     }
 
     return -1; 
 }
 
-void ensure_allocator_initialized() {
-    if (global_allocator == NULL) {
-        global_allocator = allocator_create();
+/*
+Retorna a arena da thread atual, associando uma na primeira chamada (round-robin ou pela CPU atual).
+ */
+Allocator *ensure_allocator_initialized() {
+    if (thread_allocator != NULL) return thread_allocator;
+
+    pthread_mutex_lock(&arenas_lock);
+
+    if (arena_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        arena_count = (cpus < 1) ? 1 : (cpus > MAX_ALLOCATOR_ARENAS) ? MAX_ALLOCATOR_ARENAS : (u32)cpus;
     }
-}
\ No newline at end of file
+
+    u32 index = 0;
+    if (arena_policy == ARENA_BY_CPU) {
+        int cpu = sched_getcpu();
+        index = (cpu < 0) ? 0 : (u32)cpu % arena_count;
+    } else {
+        index = next_arena++ % arena_count;
+    }
+
+    if (allocator_arenas[index] == NULL) {
+        allocator_arenas[index] = allocator_create();
+        if (allocator_arenas[index] != NULL) allocator_arenas[index]->arena_index = index;
+    }
+    thread_allocator = allocator_arenas[index];
+
+    pthread_mutex_unlock(&arenas_lock);
+    return thread_allocator;
+}
+
+/*
+Configuração das arenas. Vale para threads que ainda não fizeram a primeira alocação.
+ */
+void allocator_set_arena_count(u32 count) {
+    if (count < 1) count = 1;
+    if (count > MAX_ALLOCATOR_ARENAS) count = MAX_ALLOCATOR_ARENAS;
+
+    pthread_mutex_lock(&arenas_lock);
+    arena_count = count;
+    pthread_mutex_unlock(&arenas_lock);
+}
+
+void allocator_set_arena_policy(Arena_Policy policy) {
+    pthread_mutex_lock(&arenas_lock);
+    arena_policy = policy;
+    pthread_mutex_unlock(&arenas_lock);
+}
+
+/*
+Ativa o cache por CPU (rseq) na frente das generic pools. Retorna false se o kernel não suportar rseq,
+nesse caso palloc()/pool_free() continuam no caminho com lock. Chamar antes de criar threads.
+ */
+bool pool_enable_percpu_cache() {
+    return percpu_cache_init(SMALL_GENERIC_POOLS);
+}
+
+int allocator_get_thread_arena() {
+    Allocator *allocator = ensure_allocator_initialized();
+    return (allocator == NULL) ? -1 : (int)allocator->arena_index;
+}
+
+void pool_set_chunk_reserve(Pool *pool, size_t max_empty_chunks) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->parent_allocator->lock);
+    pool->max_empty_chunks = (u16)max_empty_chunks;
+
+    while (pool->empty_count > pool->max_empty_chunks) {
+        Pool_Chunk *chunk = pool->empty_chunks;
+        pool->empty_chunks = chunk->next;
+        pool->empty_count--;
+        allocator_release_chunk(pool->parent_allocator, chunk);
+    }
+    pthread_mutex_unlock(&pool->parent_allocator->lock);
+}
+
+// Aplica o limite da reserva global em todas as arenas
+void pool_set_global_chunk_reserve(size_t max_empty_chunks) {
+    ensure_allocator_initialized();
+
+    pthread_mutex_lock(&arenas_lock);
+    for (u32 i = 0; i < MAX_ALLOCATOR_ARENAS; i++) {
+        Allocator *allocator = allocator_arenas[i];
+        if (allocator == NULL) continue;
+
+        pthread_mutex_lock(&allocator->lock);
+        allocator->max_global_empty_chunks = (u16)max_empty_chunks;
+
+        for (size_t order = 0; order <= MAX_BIN_ORDER; order++) {
+            while (allocator->empty_count[order] > allocator->max_global_empty_chunks) {
+                Pool_Chunk *chunk = allocator->empty_chunks[order];
+                allocator->empty_chunks[order] = chunk->next;
+                allocator->empty_count[order]--;
+                allocator->reserve_stats.chunks_released++;
+                backend_free(chunk);
+            }
+        }
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+}
+
+/*
+Object Cache: pool customizada (não compartilhada) cujos blocos livres permanecem construídos.
+ */
+Object_Cache *object_cache_create(size_t size, Object_Ctor ctor, Object_Dtor dtor) {
+    Allocator *allocator = ensure_allocator_initialized();
+    if (allocator == NULL) return NULL;
+
+    size_t alignment = (size < DEFAULT_ALIGNMENT) ? 8 : DEFAULT_ALIGNMENT;
+    size_t object_size = align_size(size, sizeof(Pool_Block));
+    size_t block_size = align_size(object_size + sizeof(Pool_Block), alignment);
+
+    if (block_size > MAX_SMALL_POOL_BLOCK_SIZE) {
+        fprintf(stderr, "Error [%s]: Requested size can't be larger than %d bytes.\n", __func__, MAX_SMALL_POOL_BLOCK_SIZE);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&allocator->lock);
+
+    Pool *cache = allocator_get_custom_slot(allocator);
+    if (cache == NULL) {
+        pthread_mutex_unlock(&allocator->lock);
+        fprintf(stderr, "Error [%s]: Out of custom pools!\n", __func__);
+        return NULL;
+    }
+
+    pool_init(cache, allocator, block_size, alignment);
+    cache->is_custom = true;
+    cache->ref_count = 1;
+    cache->ctor = ctor;
+    cache->dtor = dtor;
+    cache->object_size = size;
+    cache->link_offset = object_size;
+
+    pool_get_memory(cache);
+
+    pthread_mutex_unlock(&allocator->lock);
+    return cache;
+}
+
+void *object_cache_alloc(Object_Cache *cache) {
+    return pool_alloc(cache);
+}
+
+void object_cache_free(void *obj) {
+    pool_free(obj);
+}
+
+void object_cache_destroy(Object_Cache *cache) {
+    pool_destroy(cache);
+}
+
+void pool_set_cache_coloring(bool enabled) {
+    cache_coloring_enabled = enabled;
+}
+
+// Soma os contadores de todas as arenas
+Pool_Reserve_Stats pool_get_reserve_stats() {
+    Pool_Reserve_Stats total = {0};
+
+    pthread_mutex_lock(&arenas_lock);
+    for (u32 i = 0; i < MAX_ALLOCATOR_ARENAS; i++) {
+        Allocator *allocator = allocator_arenas[i];
+        if (allocator == NULL) continue;
+
+        pthread_mutex_lock(&allocator->lock);
+        total.pool_reserve_hits += allocator->reserve_stats.pool_reserve_hits;
+        total.global_reserve_hits += allocator->reserve_stats.global_reserve_hits;
+        total.backend_refills += allocator->reserve_stats.backend_refills;
+        total.chunks_retained += allocator->reserve_stats.chunks_retained;
+        total.chunks_released += allocator->reserve_stats.chunks_released;
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+
+    return total;
+}
+
+/*
+Percorre as pools genéricas de todas as arenas. Um chunk "preso" tem poucos blocos vivos
+(uso abaixo de PINNED_CHUNK_USAGE_TRESHOLD) e por isso não volta ao backend.
+ */
+Pool_Lifetime_Stats pool_get_lifetime_stats() {
+    Pool_Lifetime_Stats stats = {0};
+
+    pthread_mutex_lock(&arenas_lock);
+    for (u32 i = 0; i < MAX_ALLOCATOR_ARENAS; i++) {
+        Allocator *allocator = allocator_arenas[i];
+        if (allocator == NULL) continue;
+
+        pthread_mutex_lock(&allocator->lock);
+        for (u32 lifetime = 0; lifetime < LIFETIME_COUNT; lifetime++) {
+            Pool *pools = (lifetime == LIFETIME_LONG) ? allocator->long_lived_pools : allocator->generic_pools;
+
+            for (u32 j = 0; j < MAX_GENERIC_POOLS; j++) {
+                for (Pool_Chunk *chunk = pools[j].head_chunk; chunk != NULL; chunk = chunk->next) {
+                    stats.chunks[lifetime]++;
+                    stats.live_blocks[lifetime] += chunk->used_count;
+
+                    f32 usage = (f32)chunk->used_count / (f32)chunk->capacity;
+                    if (chunk->used_count > 0 && usage < PINNED_CHUNK_USAGE_TRESHOLD) {
+                        stats.pinned_chunks[lifetime]++;
+                        stats.pinned_bytes[lifetime] += REQUEST_SIZE_FROM_ORDER(get_descriptor(chunk)->order);
+                    }
+                }
+            }
+        }
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+
+    return stats;
+}
+
+/*
+Fragmentação das classes do palloc: ocupação dos chunks, fragmentação interna (tamanho pedido x block_size,
+acumulada pelo mm_stats) e chunks vazios parados nas reservas de todas as pools.
+ */
+Pool_Fragmentation pool_get_fragmentation() {
+    Pool_Fragmentation frag;
+    memset(&frag, 0, sizeof(frag));
+
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) frag.classes[i].block_size = get_pool_size_from_index(i);
+
+    pthread_mutex_lock(&arenas_lock);
+    for (u32 a = 0; a < MAX_ALLOCATOR_ARENAS; a++) {
+        Allocator *allocator = allocator_arenas[a];
+        if (allocator == NULL) continue;
+
+        pthread_mutex_lock(&allocator->lock);
+        for (u32 lifetime = 0; lifetime < LIFETIME_COUNT; lifetime++) {
+            Pool *pools = (lifetime == LIFETIME_LONG) ? allocator->long_lived_pools : allocator->generic_pools;
+
+            for (u32 j = 0; j < MAX_GENERIC_POOLS; j++) {
+                Pool_Class_Fragmentation *class = &frag.classes[j];
+
+                for (Pool_Chunk *chunk = pools[j].head_chunk; chunk != NULL; chunk = chunk->next) {
+                    class->chunks++;
+                    class->chunk_bytes += REQUEST_SIZE_FROM_ORDER(get_descriptor(chunk)->order);
+                    class->capacity += chunk->capacity;
+                    class->live_blocks += chunk->used_count;
+
+                    size_t bucket = chunk->used_count * POOL_OCCUPANCY_BUCKETS / chunk->capacity;
+                    class->occupancy[(bucket < POOL_OCCUPANCY_BUCKETS) ? bucket : POOL_OCCUPANCY_BUCKETS - 1]++;
+                }
+
+                for (Pool_Chunk *chunk = pools[j].empty_chunks; chunk != NULL; chunk = chunk->next) {
+                    frag.reserved_chunks++;
+                    frag.reserved_bytes += REQUEST_SIZE_FROM_ORDER(get_descriptor(chunk)->order);
+                }
+            }
+        }
+
+        for (Custom_Pool_Page *page = allocator->custom_pool_pages; page != NULL; page = page->next) {
+            for (size_t i = 0; i < page->count; i++) {
+                for (Pool_Chunk *chunk = page->pools[i].empty_chunks; chunk != NULL; chunk = chunk->next) {
+                    frag.reserved_chunks++;
+                    frag.reserved_bytes += REQUEST_SIZE_FROM_ORDER(get_descriptor(chunk)->order);
+                }
+            }
+        }
+
+        for (u32 order = 0; order <= MAX_BIN_ORDER; order++) {
+            frag.reserved_chunks += allocator->empty_count[order];
+            frag.reserved_bytes += allocator->empty_count[order] * REQUEST_SIZE_FROM_ORDER(order);
+        }
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+
+    Mm_Stats stats = mm_stats_get();
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        Pool_Class_Fragmentation *class = &frag.classes[i];
+
+        double delivered = (double)stats.classes[i].allocs * (double)class->block_size;
+        class->internal_fragmentation = (delivered > 0) ? 1.0 - (double)stats.classes[i].requested_bytes / delivered : 0.0;
+
+        double block_bytes = (double)class->capacity * (double)class->block_size;
+        class->chunk_overhead = class->chunk_bytes ? 1.0 - block_bytes / (double)class->chunk_bytes : 0.0;
+    }
+
+    return frag;
+}
+
+/*
+Bytes de blocos vivos por página do backend (índices de backend_page_index()), para todas as pools
+(genéricas, de vida longa, customizadas e Object Caches) e os chunks das reservas (0 vivos).
+Só as páginas de chunks são escritas: o chamador inicializa as outras.
+ */
+void pool_get_page_usage(u32 *live_bytes, size_t max_pages) {
+    if (live_bytes == NULL) return;
+
+    pthread_mutex_lock(&arenas_lock);
+    for (u32 a = 0; a < MAX_ALLOCATOR_ARENAS; a++) {
+        Allocator *allocator = allocator_arenas[a];
+        if (allocator == NULL) continue;
+
+        pthread_mutex_lock(&allocator->lock);
+        for (u32 lifetime = 0; lifetime < LIFETIME_COUNT; lifetime++) {
+            Pool *pools = (lifetime == LIFETIME_LONG) ? allocator->long_lived_pools : allocator->generic_pools;
+
+            for (u32 j = 0; j < MAX_GENERIC_POOLS; j++) {
+                for (Pool_Chunk *chunk = pools[j].head_chunk; chunk != NULL; chunk = chunk->next) {
+                    pool_chunk_page_usage(chunk, live_bytes, max_pages);
+                }
+                for (Pool_Chunk *chunk = pools[j].empty_chunks; chunk != NULL; chunk = chunk->next) {
+                    pool_chunk_page_usage(chunk, live_bytes, max_pages);
+                }
+            }
+        }
+
+        // Slots livres têm as listas vazias (pool_destroy)
+        for (Custom_Pool_Page *page = allocator->custom_pool_pages; page != NULL; page = page->next) {
+            for (size_t i = 0; i < page->count; i++) {
+                for (Pool_Chunk *chunk = page->pools[i].head_chunk; chunk != NULL; chunk = chunk->next) {
+                    pool_chunk_page_usage(chunk, live_bytes, max_pages);
+                }
+                for (Pool_Chunk *chunk = page->pools[i].empty_chunks; chunk != NULL; chunk = chunk->next) {
+                    pool_chunk_page_usage(chunk, live_bytes, max_pages);
+                }
+            }
+        }
+
+        for (u32 order = 0; order <= MAX_BIN_ORDER; order++) {
+            for (Pool_Chunk *chunk = allocator->empty_chunks[order]; chunk != NULL; chunk = chunk->next) {
+                pool_chunk_page_usage(chunk, live_bytes, max_pages);
+            }
+        }
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+}
+
+/*
+Páginas do chunk em 'live_bytes': todos os blocos, menos os da free_list. Chamado com o lock da arena.
+ */
+void pool_chunk_page_usage(Pool_Chunk *chunk, u32 *live_bytes, size_t max_pages) {
+    size_t first_page = backend_page_index(chunk);
+    if (first_page == SIZE_MAX) return;
+
+    size_t chunk_pages = (size_t)1 << get_descriptor(chunk)->order;
+    for (size_t i = first_page; i < first_page + chunk_pages && i < max_pages; i++) live_bytes[i] = 0;
+
+    // Chunk vazio (ou da reserva global, sem pool): nada vivo
+    if (chunk->parent_pool == NULL || chunk->used_count == 0) return;
+
+    pool_add_page_bytes(live_bytes, max_pages, first_page, chunk, (u8*)chunk->data_start, chunk->capacity * chunk->block_size, 1);
+
+    for (Pool_Block *block = chunk->free_list; block != NULL; block = block->next) {
+        u8 *start = (u8*)block - chunk->link_offset;
+        pool_add_page_bytes(live_bytes, max_pages, first_page, chunk, start, chunk->block_size, -1);
+    }
+}
+
+// Soma (ou subtrai) 'length' bytes a partir de 'start' nas páginas que o intervalo cobre
+void pool_add_page_bytes(u32 *live_bytes, size_t max_pages, size_t first_page, Pool_Chunk *chunk, u8 *start, size_t length, i64 sign) {
+    size_t page_size = backend_page_size();
+    size_t offset = (size_t)(start - (u8*)chunk);
+    size_t end = offset + length;
+
+    while (offset < end) {
+        size_t page = offset / page_size;
+        size_t page_end = (page + 1) * page_size;
+        size_t bytes = ((end < page_end) ? end : page_end) - offset;
+
+        if (first_page + page < max_pages) live_bytes[first_page + page] += (u32)(sign * (i64)bytes);
+        offset += bytes;
+    }
+}
@@ -0,0 +1,359 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/trace.h"
+
+
+// ==========================
+//  ESTRUTURAS PRINCIPAIS
+// ==========================
+
+#define TRACE_MAGIC 0x4543415254434C50ULL // "PLCTRACE"
+#define TRACE_VERSION 1
+#define TRACE_MAX_EVENT_SIZE (1 + 3 * 10) // Byte de operação + 3 varints de 64 bits
+
+// Ocupa o bloco 0 do arquivo
+typedef struct Trace_File_Header {
+    u64 magic;
+    u32 version;
+    u32 block_size;
+    u64 block_count; // Blocos de eventos (sem contar o 0), preenchido no trace_stop
+    u64 dropped;     // Eventos perdidos por falta de espaço no arquivo
+} Trace_File_Header;
+
+typedef struct Trace_Block_Header {
+    u32 thread;
+    u32 used;    // Bytes de eventos depois do header
+    u64 base_ns; // Deltas de tempo do bloco partem daqui
+} Trace_Block_Header;
+
+// Estado de gravação da thread (reiniciado quando 'generation' muda)
+typedef struct Trace_Thread {
+    u32 generation;
+    u32 thread;
+    Trace_Block_Header *block;
+    u8 *cursor;
+    u8 *end;
+    u64 last_ns;
+    u64 last_address;
+} Trace_Thread;
+
+typedef struct Trace_State {
+    int fd;
+    u8 *base;
+    size_t max_blocks;
+    u64 start_ns;
+    u64 next_block; // Próximo bloco livre (fetch_add)
+    u32 next_thread;
+    u32 generation;
+    u64 dropped;
+} Trace_State;
+
+bool trace_enabled = false;
+static Trace_State trace_state = { .fd = -1 };
+static _Thread_local Trace_Thread trace_thread;
+
+// DECLARAÇÕES
+static u64 trace_now();
+static u64 trace_clock_ns();
+static bool trace_claim_block(Trace_Thread *thread, u64 now);
+static u8 *trace_put_varint(u8 *out, u64 value);
+static bool trace_get_varint(const u8 **in, const u8 *end, u64 *value);
+static int trace_compare_events(const void *a, const void *b);
+
+// ==========================
+//  FUNÇÕES PRINCIPAIS
+// ==========================
+
+bool trace_start(const char *path, size_t max_size) {
+    if (trace_is_enabled()) {
+        fprintf(stderr, "Error: Trace already running [trace_start()]\n");
+        return false;
+    }
+
+    if (max_size == 0) max_size = TRACE_DEFAULT_MAX_SIZE;
+    size_t max_blocks = max_size / TRACE_BLOCK_SIZE;
+    if (max_blocks < 2) {
+        fprintf(stderr, "Error: Trace size too small [trace_start()]\n");
+        return false;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("trace_start");
+        return false;
+    }
+
+    // Arquivo esparso: só os blocos escritos ocupam disco
+    size_t file_size = max_blocks * TRACE_BLOCK_SIZE;
+    if (ftruncate(fd, (off_t)file_size) != 0) {
+        perror("trace_start");
+        close(fd);
+        return false;
+    }
+
+    u8 *base = (u8*)mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("trace_start");
+        close(fd);
+        return false;
+    }
+
+    Trace_File_Header *header = (Trace_File_Header*)base;
+    header->magic = TRACE_MAGIC;
+    header->version = TRACE_VERSION;
+    header->block_size = TRACE_BLOCK_SIZE;
+
+    trace_state.fd = fd;
+    trace_state.base = base;
+    trace_state.max_blocks = max_blocks;
+    trace_state.start_ns = trace_clock_ns(); // Relógio cru: trace_now() desconta o start_ns do trace anterior
+    trace_state.next_block = 1;
+    trace_state.next_thread = 0;
+    trace_state.dropped = 0;
+    trace_state.generation++; // Invalida o estado de threads de um trace anterior
+
+    __atomic_store_n(&trace_enabled, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+void trace_stop() {
+    if (!trace_is_enabled()) return;
+    __atomic_store_n(&trace_enabled, false, __ATOMIC_RELEASE);
+
+    u64 used_blocks = trace_state.next_block;
+    if (used_blocks > trace_state.max_blocks) used_blocks = trace_state.max_blocks;
+
+    Trace_File_Header *header = (Trace_File_Header*)trace_state.base;
+    header->block_count = used_blocks - 1;
+    header->dropped = trace_state.dropped;
+
+    if (trace_state.dropped > 0) {
+        fprintf(stderr, "Warning: trace file full, %lu events dropped\n", (unsigned long)trace_state.dropped);
+    }
+
+    munmap(trace_state.base, trace_state.max_blocks * TRACE_BLOCK_SIZE);
+    if (ftruncate(trace_state.fd, (off_t)(used_blocks * TRACE_BLOCK_SIZE)) != 0) {
+        perror("trace_stop");
+    }
+    close(trace_state.fd);
+
+    trace_state.fd = -1;
+    trace_state.base = NULL;
+}
+
+/*
+Grava um evento no bloco da thread. Alocações: chamar depois da operação (com o ponteiro devolvido);
+frees: antes. Assim, ordenando por tempo, o free de um endereço sempre vem antes da sua reutilização.
+ */
+void trace_record(u8 op, void *ptr, size_t size) {
+    if (ptr == NULL) return;
+
+    Trace_Thread *thread = &trace_thread;
+    u64 now = trace_now();
+
+    if (thread->generation != trace_state.generation) {
+        thread->generation = trace_state.generation;
+        thread->thread = __atomic_fetch_add(&trace_state.next_thread, 1, __ATOMIC_RELAXED);
+        thread->block = NULL;
+    }
+
+    if (thread->block == NULL || (size_t)(thread->end - thread->cursor) < TRACE_MAX_EVENT_SIZE) {
+        if (!trace_claim_block(thread, now)) {
+            __atomic_fetch_add(&trace_state.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    u64 address = (u64)(uintptr_t)ptr;
+    i64 address_delta = (i64)(address - thread->last_address);
+    u64 zigzag = ((u64)address_delta << 1) ^ (u64)(address_delta >> 63);
+
+    u8 *out = thread->cursor;
+    *out++ = op;
+    out = trace_put_varint(out, now - thread->last_ns);
+    out = trace_put_varint(out, zigzag);
+
+    u8 kind = op & TRACE_OP_MASK;
+    if (kind == TRACE_OP_PALLOC || kind == TRACE_OP_BACKEND_ALLOC) {
+        out = trace_put_varint(out, size);
+    }
+
+    thread->cursor = out;
+    thread->last_ns = now;
+    thread->last_address = address;
+    thread->block->used = (u32)(out - (u8*)(thread->block + 1));
+}
+
+/*
+Decodifica todos os blocos e ordena por tempo. Empates: frees antes das alocações
+(o free de um endereço nunca é posterior à alocação que o reutiliza).
+ */
+Trace_Event *trace_load(const char *path, size_t *count, u32 *threads) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Trace_File_Header)) {
+        fprintf(stderr, "Error: Invalid trace file [trace_load()]\n");
+        close(fd);
+        return NULL;
+    }
+
+    u8 *base = (u8*)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    const Trace_File_Header *header = (const Trace_File_Header*)base;
+    if (header->magic != TRACE_MAGIC || header->version != TRACE_VERSION || header->block_size != TRACE_BLOCK_SIZE ||
+        (header->block_count + 1) * header->block_size > (u64)st.st_size) {
+        fprintf(stderr, "Error: Invalid trace file [trace_load()]\n");
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    // Limite superior de eventos: um por 3 bytes de payload
+    size_t capacity = 1;
+    for (u64 b = 1; b <= header->block_count; b++) {
+        capacity += ((const Trace_Block_Header*)(base + b * header->block_size))->used / 3;
+    }
+
+    // mmap em vez de malloc: o replay com a glibc não herda um heap com a trace inteira
+    Trace_Event *events = (Trace_Event*)mmap(NULL, capacity * sizeof(Trace_Event), PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (events == MAP_FAILED) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    size_t n = 0;
+    u32 max_thread = 0;
+    for (u64 b = 1; b <= header->block_count; b++) {
+        const Trace_Block_Header *block = (const Trace_Block_Header*)(base + b * header->block_size);
+        const u8 *in = (const u8*)(block + 1);
+        const u8 *end = in + block->used;
+        if (block->used > header->block_size - sizeof(Trace_Block_Header)) continue;
+
+        u64 now = block->base_ns;
+        u64 address = 0;
+        if (block->thread + 1 > max_thread) max_thread = block->thread + 1;
+
+        while (in < end) {
+            u8 op = *in++;
+            u64 delta = 0, zigzag = 0, size = 0;
+            if (!trace_get_varint(&in, end, &delta) || !trace_get_varint(&in, end, &zigzag)) break;
+
+            u8 kind = op & TRACE_OP_MASK;
+            if ((kind == TRACE_OP_PALLOC || kind == TRACE_OP_BACKEND_ALLOC) && !trace_get_varint(&in, end, &size)) break;
+
+            now += delta;
+            address += (u64)((i64)(zigzag >> 1) ^ -(i64)(zigzag & 1));
+            events[n++] = (Trace_Event){ now, address, size, block->thread, op };
+        }
+    }
+
+    munmap(base, (size_t)st.st_size);
+
+    // Devolve a sobra da estimativa: o array fica com exatamente count + 1 posições (ver trace_free_events)
+    if (n + 1 < capacity) {
+        void *shrunk = mremap(events, capacity * sizeof(Trace_Event), (n + 1) * sizeof(Trace_Event), 0);
+        if (shrunk != MAP_FAILED) events = (Trace_Event*)shrunk;
+    }
+
+    qsort(events, n, sizeof(Trace_Event), trace_compare_events);
+
+    *count = n;
+    if (threads) *threads = max_thread;
+
+    // Mesmo sem eventos devolve o array (vazio), para distinguir de erro
+    return events;
+}
+
+void trace_free_events(Trace_Event *events, size_t count) {
+    if (events == NULL) return;
+    munmap(events, (count + 1) * sizeof(Trace_Event));
+}
+
+// ==========================
+//  FUNÇÕES AUXILIARES
+// ==========================
+
+// Nanossegundos desde o trace_start()
+static u64 trace_now() {
+    return trace_clock_ns() - trace_state.start_ns;
+}
+
+static u64 trace_clock_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool trace_claim_block(Trace_Thread *thread, u64 now) {
+    u64 index = __atomic_fetch_add(&trace_state.next_block, 1, __ATOMIC_RELAXED);
+    if (index >= trace_state.max_blocks) {
+        thread->block = NULL;
+        return false;
+    }
+
+    Trace_Block_Header *block = (Trace_Block_Header*)(trace_state.base + index * TRACE_BLOCK_SIZE);
+    block->thread = thread->thread;
+    block->used = 0;
+    block->base_ns = now;
+
+    thread->block = block;
+    thread->cursor = (u8*)(block + 1);
+    thread->end = (u8*)block + TRACE_BLOCK_SIZE;
+    thread->last_ns = now;
+    thread->last_address = 0;
+    return true;
+}
+
+// LEB128: 7 bits por byte, bit alto = continua
+static u8 *trace_put_varint(u8 *out, u64 value) {
+    while (value >= 0x80) {
+        *out++ = (u8)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (u8)value;
+    return out;
+}
+
+static bool trace_get_varint(const u8 **in, const u8 *end, u64 *value) {
+    u64 result = 0;
+    for (u32 shift = 0; shift < 64 && *in < end; shift += 7) {
+        u8 byte = *(*in)++;
+        result |= (u64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int trace_compare_events(const void *a, const void *b) {
+    const Trace_Event *x = (const Trace_Event*)a;
+    const Trace_Event *y = (const Trace_Event*)b;
+
+    if (x->timestamp != y->timestamp) return (x->timestamp < y->timestamp) ? -1 : 1;
+
+    bool x_free = ((x->op & TRACE_OP_MASK) == TRACE_OP_POOL_FREE || (x->op & TRACE_OP_MASK) == TRACE_OP_BACKEND_FREE);
+    bool y_free = ((y->op & TRACE_OP_MASK) == TRACE_OP_POOL_FREE || (y->op & TRACE_OP_MASK) == TRACE_OP_BACKEND_FREE);
+    if (x_free != y_free) return x_free ? -1 : 1;
+
+    return (x->thread < y->thread) ? -1 : (x->thread > y->thread);
+}
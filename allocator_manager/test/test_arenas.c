@@ -0,0 +1,82 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Arenas: threads novas recebem arenas em round-robin, blocos liberados por outra thread voltam
+para a arena dona, e ARENA_BY_CPU só entrega arenas dentro de allocator_set_arena_count().
+ */
+
+#define ARENA_COUNT 4
+#define THREAD_COUNT (2 * ARENA_COUNT)
+#define BLOCKS_PER_THREAD 512
+
+typedef struct Arena_Thread {
+    int arena;
+    void *blocks[BLOCKS_PER_THREAD];
+} Arena_Thread;
+
+static void *arena_thread(void *arg) {
+    Arena_Thread *thread = arg;
+    thread->arena = allocator_get_thread_arena();
+
+    for (int i = 0; i < BLOCKS_PER_THREAD; i++) {
+        size_t size = 16 + (size_t)(i % 32) * 16;
+        thread->blocks[i] = palloc(size);
+        CHECK(thread->blocks[i] != NULL);
+        memset(thread->blocks[i], thread->arena, size);
+    }
+    return NULL;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+
+    allocator_set_arena_count(ARENA_COUNT);
+    allocator_set_arena_policy(ARENA_ROUND_ROBIN);
+
+    // Uma thread por vez: a ordem de associação é a ordem de criação
+    static Arena_Thread threads[THREAD_COUNT];
+    int used[ARENA_COUNT] = {0};
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_t tid;
+        CHECK(pthread_create(&tid, NULL, arena_thread, &threads[i]) == 0);
+        CHECK(pthread_join(tid, NULL) == 0);
+
+        CHECK(threads[i].arena >= 0 && threads[i].arena < ARENA_COUNT);
+        if (i > 0) CHECK(threads[i].arena == (threads[i - 1].arena + 1) % ARENA_COUNT);
+        used[threads[i].arena]++;
+    }
+    for (int i = 0; i < ARENA_COUNT; i++) CHECK(used[i] == THREAD_COUNT / ARENA_COUNT);
+
+    // Free remoto: a thread principal (outra arena) devolve os blocos das threads que já terminaram
+    Pool_Lifetime_Stats before = pool_get_lifetime_stats();
+    CHECK(before.live_blocks[LIFETIME_SHORT] >= THREAD_COUNT * BLOCKS_PER_THREAD);
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        for (int j = 0; j < BLOCKS_PER_THREAD; j++) {
+            CHECK(((unsigned char*)threads[i].blocks[j])[0] == (unsigned char)threads[i].arena);
+            pool_free(threads[i].blocks[j]);
+        }
+    }
+    Pool_Lifetime_Stats after = pool_get_lifetime_stats();
+    CHECK(before.live_blocks[LIFETIME_SHORT] - after.live_blocks[LIFETIME_SHORT] == THREAD_COUNT * BLOCKS_PER_THREAD);
+
+    // Por CPU: índice = CPU % arena_count
+    allocator_set_arena_policy(ARENA_BY_CPU);
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_t tid;
+        Arena_Thread *thread = &threads[i];
+        CHECK(pthread_create(&tid, NULL, arena_thread, thread) == 0);
+        CHECK(pthread_join(tid, NULL) == 0);
+        CHECK(thread->arena >= 0 && thread->arena < ARENA_COUNT);
+        for (int j = 0; j < BLOCKS_PER_THREAD; j++) pool_free(thread->blocks[j]);
+    }
+
+    TEST_PASS("arenas");
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Geometria do backend em tempo de execução: configs inválidas são recusadas, e com páginas de 16 KB
+e ordem máxima 10 blocos de até 16 MB saem da reserva (acima disso, huge).
+ */
+
+#define TEST_PAGE_SIZE ((size_t)16 << 10)
+#define TEST_MAX_ORDER 10
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+
+    // Página que não é potência de 2, menor que a do sistema, ordem acima do limite, reserva pequena demais
+    config.page_size = 3 * PAGE_SIZE;
+    CHECK(!backend_init(&config));
+    config.page_size = 512;
+    CHECK(!backend_init(&config));
+    config.page_size = TEST_PAGE_SIZE;
+    config.max_order = MAX_BIN_ORDER_LIMIT + 1;
+    CHECK(!backend_init(&config));
+    config.max_order = TEST_MAX_ORDER;
+    config.reserve_size = TEST_PAGE_SIZE << TEST_MAX_ORDER;
+    CHECK(!backend_init(&config));
+
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+    CHECK(backend_page_size() == TEST_PAGE_SIZE);
+    CHECK(backend_max_order() == TEST_MAX_ORDER);
+    CHECK(REQUEST_SIZE_FROM_ORDER(TEST_MAX_ORDER) == (size_t)16 << 20);
+
+    // Uma página: o split deixa um bloco livre em cada ordem abaixo da máxima
+    void *page = backend_alloc(1, OWNER_HEAP);
+    CHECK(page != NULL);
+    CHECK(backend_usable_size(page) == TEST_PAGE_SIZE);
+    Backend_Fragmentation frag = backend_get_fragmentation();
+    for (u32 k = 0; k < TEST_MAX_ORDER; k++) CHECK(frag.free_blocks[k] >= 1);
+
+    // Cada ordem sai da sua bin, sem passar pela reserva de novo
+    void *blocks[TEST_MAX_ORDER];
+    for (u32 k = 0; k < TEST_MAX_ORDER; k++) {
+        blocks[k] = backend_alloc(REQUEST_SIZE_FROM_ORDER(k), OWNER_HEAP);
+        CHECK(blocks[k] != NULL);
+        CHECK(!is_huge_allocation(blocks[k]));
+        CHECK(backend_usable_size(blocks[k]) == REQUEST_SIZE_FROM_ORDER(k));
+    }
+    CHECK(backend_get_fragmentation().committed_pages == frag.committed_pages);
+
+    // 16 MB ainda vem da reserva; 16 MB + 1 vai para o caminho huge
+    void *largest = backend_alloc(REQUEST_SIZE_FROM_ORDER(TEST_MAX_ORDER), OWNER_HEAP);
+    CHECK(largest != NULL && !is_huge_allocation(largest));
+    void *huge = backend_alloc(REQUEST_SIZE_FROM_ORDER(TEST_MAX_ORDER) + 1, OWNER_HEAP);
+    CHECK(huge != NULL && is_huge_allocation(huge));
+
+    // Chunks das pools com a página maior
+    void *small = palloc(24);
+    void *medium = palloc(MAX_POOL_BLOCK_SIZE);
+    CHECK(small != NULL && medium != NULL);
+    pool_free(small);
+    pool_free(medium);
+
+    backend_free(huge);
+    backend_free(largest);
+    for (u32 k = 0; k < TEST_MAX_ORDER; k++) backend_free(blocks[k]);
+    backend_free(page);
+
+    TEST_PASS("backend_geometry");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Ordens máximas cujo bloco não comporta um chunk das classes médias: o backend funciona sozinho, mas
+as pools recusam criar a arena e palloc() retorna NULL (antes: max_order = 1 era aceito e palloc(8000)
+quebrava no slice de um chunk sem blocos). Cada ordem pequena roda em um processo filho.
+ */
+
+static void small_order_child(u32 order) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.max_order = order;
+    CHECK(backend_init(&config));
+
+    void *page = backend_alloc(backend_page_size(), OWNER_HEAP);
+    CHECK(page != NULL);
+    backend_free(page);
+
+    CHECK(palloc(8) == NULL);
+    CHECK(palloc(8000) == NULL);
+    CHECK(pool_create(64) == NULL);
+}
+
+int main(void) {
+    for (u32 order = 0; order <= MAX_BIN_ORDER_LIMIT; order++) {
+        if (((size_t)PAGE_SIZE << order) >= pool_min_chunk_size()) break;
+
+        pid_t pid = fork();
+        CHECK(pid >= 0);
+        if (pid == 0) {
+            small_order_child(order);
+            exit(0);
+        }
+
+        int status = 0;
+        CHECK(waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.max_order = MAX_BIN_ORDER;
+    CHECK(backend_init(&config));
+    CHECK(backend_page_size() << backend_max_order() >= pool_min_chunk_size());
+
+    // Toda classe do palloc, inclusive as médias, precisa sair de um chunk da reserva
+    for (size_t size = 1; size <= MAX_POOL_BLOCK_SIZE; size += (size < 1024) ? 1 : 97) {
+        void *ptr = palloc(size);
+        CHECK(ptr != NULL);
+        CHECK(pool_usable_size(ptr) >= size);
+        pool_free(ptr);
+    }
+
+    void *largest = palloc(MAX_POOL_BLOCK_SIZE);
+    CHECK(largest != NULL);
+    pool_free(largest);
+
+    TEST_PASS("backend_min_order");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "backend_manager.h"
+#include "mm_stats.h"
+#include "test_utils.h"
+
+/*
+backend_purge(): só a cauda da reserva (blocos livres de ordem máxima depois do último bloco em uso)
+volta ao SO, blocos já zerados não são devolvidos de novo e purged_pages conta só páginas novas.
+Roda nos dois engines, cada um em um processo filho.
+ */
+
+static size_t purge_pages() {
+    u64 before = mm_stats_get().purged_pages;
+    size_t bytes = backend_purge();
+    CHECK(mm_stats_get().purged_pages - before == bytes / backend_page_size());
+    return bytes;
+}
+
+static void purge_scenario(Backend_Engine engine) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = engine;
+    CHECK(backend_init(&config));
+
+    size_t block_size = REQUEST_SIZE_FROM_ORDER(backend_max_order());
+
+    // Três blocos de ordem máxima, em ordem de endereço, todos sujos
+    void *blocks[3];
+    for (int i = 0; i < 3; i++) {
+        blocks[i] = backend_alloc(block_size, OWNER_HEAP);
+        CHECK(blocks[i] != NULL);
+        memset(blocks[i], 0x5A, block_size);
+    }
+    CHECK(blocks[0] < blocks[1] && blocks[1] < blocks[2]);
+
+    // Nada livre na cauda
+    CHECK(purge_pages() == 0);
+
+    // Buraco no começo e cauda livre: só a cauda volta
+    backend_free(blocks[0]);
+    backend_free(blocks[2]);
+    CHECK(purge_pages() == block_size);
+
+    // Já zerada: a segunda chamada não devolve nada
+    CHECK(purge_pages() == 0);
+
+    // Com tudo livre, a cauda vai até o começo; o bloco 2 continua pulado
+    backend_free(blocks[1]);
+    CHECK(purge_pages() == 2 * block_size);
+    CHECK(purge_pages() == 0);
+
+    // Entregar de novo suja o bloco: volta a ser devolvido
+    void *again = backend_alloc(block_size, OWNER_HEAP);
+    CHECK(again == blocks[0]);
+    memset(again, 0x5A, block_size);
+    backend_free(again);
+    CHECK(purge_pages() == block_size);
+
+    // Páginas devolvidas voltam zeradas
+    again = backend_alloc(block_size, OWNER_HEAP);
+    for (size_t i = 0; i < block_size; i += 512) CHECK(((unsigned char*)again)[i] == 0);
+    backend_free(again);
+}
+
+static void run_in_child(Backend_Engine engine) {
+    pid_t pid = fork();
+    CHECK(pid >= 0);
+    if (pid == 0) {
+        purge_scenario(engine);
+        exit(0);
+    }
+
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(void) {
+    run_in_child(BACKEND_ENGINE_BINS);
+    run_in_child(BACKEND_ENGINE_BITMAP);
+
+    TEST_PASS("backend_purge");
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "benchmark.h"
+#include "test_utils.h"
+
+/*
+Profiler do benchmark.h: buckets log-lineares com erro relativo <= 1/BENCHMARK_SUB_BUCKETS,
+percentis a partir do histograma e amostras de várias threads somadas sem perder nenhuma.
+ */
+
+#define THREAD_COUNT 8
+#define SAMPLES_PER_THREAD 10000
+
+static void *profiled_thread(void *arg) {
+    (void)arg;
+    for (int i = 0; i < SAMPLES_PER_THREAD; i++) {
+        BENCHMARK_START_NAME("threaded_site");
+        volatile int sink = i;
+        (void)sink;
+        BENCHMARK_END();
+    }
+    return NULL;
+}
+
+int main(void) {
+    // Bucket -> valor representativo: monotônico e dentro do erro relativo
+    uint32_t last_index = 0;
+    for (uint64_t ticks = 1; ticks < ((uint64_t)1 << 40); ticks += 1 + ticks / 37) {
+        uint32_t index = benchmark_bucket_index(ticks);
+        CHECK(index < BENCHMARK_BUCKETS);
+        CHECK(index >= last_index);
+        last_index = index;
+
+        double value = (double)benchmark_bucket_value(index);
+        double error = (value > (double)ticks) ? value - (double)ticks : (double)ticks - value;
+        CHECK(error <= (double)ticks / BENCHMARK_SUB_BUCKETS);
+    }
+    CHECK(benchmark_bucket_index(UINT64_MAX) == BENCHMARK_BUCKETS - 1);
+
+    // Percentis de uma distribuição conhecida (1..10000 ticks), sem overhead
+    static Function_Profile known = {0};
+    benchmark_register(&known, "known_site");
+    Benchmark_Counter_Values no_counters = { .valid = false };
+    for (uint64_t ticks = 1; ticks <= 10000; ticks++) benchmark_record(&known, ticks, &no_counters);
+
+    Benchmark_Histogram merged;
+    benchmark_merge_site(known.index - 1, &merged);
+    CHECK(merged.count == 10000);
+    CHECK(merged.max_ticks == 10000);
+    CHECK(merged.total_ticks == 10000ULL * 10001 / 2);
+
+    uint64_t p50 = benchmark_percentile(&merged, 0.50, 0);
+    uint64_t p99 = benchmark_percentile(&merged, 0.99, 0);
+    CHECK(p50 >= 5000 - 5000 / BENCHMARK_SUB_BUCKETS && p50 <= 5000 + 5000 / BENCHMARK_SUB_BUCKETS);
+    CHECK(p99 >= 9900 - 9900 / BENCHMARK_SUB_BUCKETS && p99 <= 10000);
+
+    // Várias threads no mesmo ponto: cada uma no seu buffer, somadas no relatório
+    pthread_t threads[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) CHECK(pthread_create(&threads[i], NULL, profiled_thread, NULL) == 0);
+    for (int i = 0; i < THREAD_COUNT; i++) CHECK(pthread_join(threads[i], NULL) == 0);
+
+    CHECK(_benchmark_site_count == 2);
+    benchmark_merge_site(1, &merged);
+    CHECK(merged.count == (uint64_t)THREAD_COUNT * SAMPLES_PER_THREAD);
+
+    uint64_t bucketed = 0;
+    for (uint32_t i = 0; i < BENCHMARK_BUCKETS; i++) bucketed += merged.buckets[i];
+    CHECK(bucketed == merged.count);
+
+    TEST_PASS("benchmark_profiler");
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <pthread.h>
+
+#include "backend_manager.h"
+#include "test_utils.h"
+
+/*
+Engine BITMAP: pares de buddies liberados ao mesmo tempo por threads diferentes precisam se fundir.
+Depois de todas as rodadas, as páginas comprometidas voltam a formar blocos de ordem máxima e um
+backend_alloc() de ordem máxima é atendido sem tirar mais nada da reserva.
+ */
+
+#define PAIRS 4
+#define THREADS (2 * PAIRS)
+#define ROUNDS 5000
+
+static void *blocks[THREADS];
+static pthread_barrier_t start_barrier;
+static pthread_barrier_t done_barrier;
+
+static void *free_worker(void *arg) {
+    size_t id = (size_t)arg;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        pthread_barrier_wait(&start_barrier);
+        backend_free(blocks[id]);
+        pthread_barrier_wait(&done_barrier);
+    }
+    return NULL;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BITMAP;
+    CHECK(backend_init(&config));
+
+    size_t page_size = backend_page_size();
+    pthread_t threads[THREADS];
+    pthread_barrier_init(&start_barrier, NULL, THREADS + 1);
+    pthread_barrier_init(&done_barrier, NULL, THREADS + 1);
+    for (size_t i = 0; i < THREADS; i++) pthread_create(&threads[i], NULL, free_worker, (void*)i);
+
+    size_t committed = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        // Menor endereço primeiro: allocs consecutivos de uma página saem em pares de buddies
+        for (size_t i = 0; i < THREADS; i++) {
+            blocks[i] = backend_alloc(page_size, OWNER_HEAP);
+            CHECK(blocks[i] != NULL);
+        }
+        for (size_t p = 0; p < PAIRS; p++) {
+            CHECK(((uintptr_t)blocks[2 * p] ^ (uintptr_t)blocks[2 * p + 1]) == page_size);
+        }
+
+        pthread_barrier_wait(&start_barrier);
+        pthread_barrier_wait(&done_barrier);
+
+        if (round == 0) committed = backend_get_fragmentation().committed_pages;
+    }
+
+    for (size_t i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+
+    Backend_Fragmentation frag = backend_get_fragmentation();
+    u32 max_order = backend_max_order();
+    CHECK(frag.committed_pages == committed);
+    CHECK(frag.free_pages == frag.committed_pages);
+    CHECK(frag.free_blocks[max_order] << max_order == frag.committed_pages);
+
+    void *largest = backend_alloc(page_size << max_order, OWNER_HEAP);
+    CHECK(largest != NULL);
+    CHECK(backend_get_fragmentation().committed_pages == committed);
+    backend_free(largest);
+
+    TEST_PASS("bitmap_concurrent_free");
+    return 0;
+}
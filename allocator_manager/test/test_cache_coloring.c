@@ -0,0 +1,71 @@
+#include <stdint.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Cache coloring: com coloring ligado o primeiro bloco de chunks consecutivos muda de deslocamento
+dentro da página; desligado, todos os chunks começam no mesmo deslocamento.
+ */
+
+#define CHUNK_COUNT 16
+#define MAX_BLOCKS 8192
+
+/*
+Aloca blocos em sequência até passar por CHUNK_COUNT chunks e conta os deslocamentos distintos
+(endereço % página) do primeiro bloco de cada chunk. Os blocos de um chunk saem em ordem crescente,
+então um salto diferente de block_size marca o começo de outro chunk.
+ */
+static int count_chunk_colors(Pool *pool, size_t block_size) {
+    static void *blocks[MAX_BLOCKS];
+    size_t offsets[CHUNK_COUNT];
+    size_t page_size = backend_page_size();
+    int chunks = 0;
+    int allocated = 0;
+
+    while (chunks < CHUNK_COUNT && allocated < MAX_BLOCKS) {
+        void *block = pool_alloc(pool);
+        CHECK(block != NULL);
+        bool chunk_start = allocated == 0 || (uintptr_t)block != (uintptr_t)blocks[allocated - 1] + block_size;
+        blocks[allocated++] = block;
+
+        if (chunk_start) offsets[chunks++] = (uintptr_t)block % page_size;
+    }
+    CHECK(chunks == CHUNK_COUNT);
+
+    int distinct = 0;
+    for (int i = 0; i < CHUNK_COUNT; i++) {
+        bool seen = false;
+        for (int j = 0; j < i; j++) {
+            if (offsets[j] == offsets[i]) seen = true;
+        }
+        if (!seen) distinct++;
+    }
+
+    for (int i = 0; i < allocated; i++) pool_free(blocks[i]);
+    return distinct;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+
+    // 496 e 480 bytes deixam sobra no fim do chunk para mais de uma cor
+    pool_set_cache_coloring(true);
+    Pool *colored = pool_create(496);
+    CHECK(colored != NULL);
+    CHECK(count_chunk_colors(colored, 496) > 1);
+
+    pool_set_cache_coloring(false);
+    Pool *plain = pool_create(480);
+    CHECK(plain != NULL);
+    CHECK(count_chunk_colors(plain, 480) == 1);
+
+    pool_destroy(colored);
+    pool_destroy(plain);
+
+    TEST_PASS("cache_coloring");
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "mem.h"
+#include "test_utils.h"
+
+/*
+Páginas sabidamente zeradas: backend_alloc_fresh() informa blocos vindos da reserva (ou de um purge)
+como zerados, e os caminhos de calloc devolvem memória zerada também depois de reusar blocos sujos.
+ */
+
+static bool is_zero(const void *ptr, size_t size) {
+    const unsigned char *bytes = ptr;
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i] != 0) return false;
+    }
+    return true;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+    backend_set_lazy_coalescing(false);
+
+    size_t size = 4 * backend_page_size();
+
+    // Recém-saído da reserva: zerado; reusado depois de sujo: não
+    bool zeroed = false;
+    void *block = backend_alloc_fresh(size, OWNER_HEAP, &zeroed);
+    CHECK(block != NULL && zeroed);
+    CHECK(is_zero(block, size));
+    memset(block, 0xAB, size);
+    backend_free(block);
+
+    void *reused = backend_alloc_fresh(size, OWNER_HEAP, &zeroed);
+    CHECK(reused == block);
+    CHECK(!zeroed);
+    backend_free(reused);
+
+    // backend_calloc sobre o bloco sujo precisa zerar
+    void *cleared = backend_calloc(size, OWNER_HEAP);
+    CHECK(cleared == block);
+    CHECK(is_zero(cleared, size));
+    memset(cleared, 0xCD, size);
+    backend_free(cleared);
+
+    // Purge devolve as páginas ao kernel: voltam zeradas
+    CHECK(backend_purge() > 0);
+    reused = backend_alloc_fresh(size, OWNER_HEAP, &zeroed);
+    CHECK(reused != NULL && zeroed);
+    CHECK(is_zero(reused, size));
+    backend_free(reused);
+
+    // Huge: mmap novo, sempre zerado
+    void *huge = backend_alloc_fresh(REQUEST_SIZE_FROM_ORDER(backend_max_order()) + 1, OWNER_HEAP, &zeroed);
+    CHECK(huge != NULL && zeroed);
+    backend_free(huge);
+
+    // pcalloc: blocos nunca entregues e blocos reusados sujos
+    void *blocks[256];
+    for (int i = 0; i < 256; i++) {
+        blocks[i] = pcalloc(96);
+        CHECK(blocks[i] != NULL && is_zero(blocks[i], 96));
+        memset(blocks[i], 0xEF, 96);
+    }
+    for (int i = 0; i < 256; i++) pool_free(blocks[i]);
+    for (int i = 0; i < 256; i++) {
+        blocks[i] = pcalloc(96);
+        CHECK(blocks[i] != NULL && is_zero(blocks[i], 96));
+    }
+    for (int i = 0; i < 256; i++) pool_free(blocks[i]);
+
+    // mem_calloc: overflow de count * size
+    CHECK(mem_calloc(SIZE_MAX / 2, 4) == NULL);
+    void *array = mem_calloc(1000, 40);
+    CHECK(array != NULL && is_zero(array, 40000));
+    mem_free(array);
+
+    TEST_PASS("calloc_zero");
+    return 0;
+}
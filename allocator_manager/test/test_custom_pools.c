@@ -0,0 +1,75 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Pools customizadas: sem limite fixo de quantidade, compartilhadas por block_size alinhado
+(ref_count até o último pool_destroy()) e crescendo sob demanda.
+ */
+
+// 8 bytes e depois múltiplos de DEFAULT_ALIGNMENT até MAX_SMALL_POOL_BLOCK_SIZE
+#define POOL_SIZES ((int)(MAX_SMALL_POOL_BLOCK_SIZE / DEFAULT_ALIGNMENT) + 1)
+
+static size_t pool_test_size(int i) {
+    return (i == 0) ? 8 : (size_t)i * DEFAULT_ALIGNMENT;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+
+    // Mais pools distintas que o antigo limite fixo (POOL_ALLOCATION_LIMIT)
+    Pool *pools[POOL_SIZES];
+    for (int i = 0; i < POOL_SIZES; i++) {
+        size_t size = pool_test_size(i);
+        pools[i] = pool_create(size);
+        CHECK(pools[i] != NULL);
+
+        void *block = pool_alloc(pools[i]);
+        CHECK(block != NULL);
+        CHECK(pool_usable_size(block) >= size);
+        memset(block, 0x3C, size);
+        pool_free(block);
+    }
+    CHECK(POOL_SIZES > POOL_ALLOCATION_LIMIT);
+
+    // Mesmo block_size depois do alinhamento: a mesma pool (33 e 48 bytes alinham em 16)
+    for (int i = 0; i < POOL_SIZES; i++) {
+        for (int j = i + 1; j < POOL_SIZES; j++) CHECK(pools[i] != pools[j]);
+    }
+    Pool *shared = pool_create(33);
+    CHECK(shared == pools[48 / DEFAULT_ALIGNMENT]);
+    CHECK(pool_create(48) == shared);
+
+    // Duas referências extras: a pool sobrevive a dois destroys
+    void *live = pool_alloc(shared);
+    CHECK(live != NULL);
+    pool_destroy(shared);
+    pool_destroy(shared);
+    void *another = pool_alloc(shared);
+    CHECK(another != NULL && another != live);
+    pool_free(another);
+    pool_free(live);
+
+    // Crescimento sob demanda: muito mais blocos que um chunk
+    static void *blocks[20000];
+    for (int i = 0; i < 20000; i++) {
+        blocks[i] = pool_alloc(pools[0]);
+        CHECK(blocks[i] != NULL);
+    }
+    for (int i = 0; i < 20000; i++) pool_free(blocks[i]);
+
+    // Último destroy libera o índice: a próxima criação é uma pool nova, vazia
+    for (int i = 0; i < POOL_SIZES; i++) pool_destroy(pools[i]);
+    Pool *fresh = pool_create(48);
+    CHECK(fresh != NULL);
+    CHECK(pool_alloc(fresh) != NULL);
+
+    CHECK(pool_create(MAX_SMALL_POOL_BLOCK_SIZE + 1) == NULL);
+
+    TEST_PASS("custom_pools");
+    return 0;
+}
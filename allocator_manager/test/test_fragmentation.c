@@ -0,0 +1,105 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "fragmentation.h"
+#include "test_utils.h"
+
+/*
+Analisador de fragmentação: páginas alternadas deixam a memória livre inutilizável para a ordem
+máxima, a fragmentação interna de uma classe segue bytes pedidos / tamanho da classe, e o page map
+tem o cabeçalho documentado e uma linha por bloco de ordem máxima.
+ */
+
+#define PAGES 64
+#define POOL_BLOCKS 1000
+#define REQUEST_SIZE 100
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+    backend_set_lazy_coalescing(false);
+
+    u32 max_order = backend_max_order();
+
+    // Tabuleiro: metade das páginas livre, nenhuma forma bloco de ordem 1
+    void *pages[PAGES];
+    for (int i = 0; i < PAGES; i++) pages[i] = backend_alloc(backend_page_size(), OWNER_HEAP);
+    for (int i = 0; i < PAGES; i += 2) backend_free(pages[i]);
+
+    Frag_Report report = frag_analyze();
+    CHECK(report.backend.free_pages == report.backend.committed_pages - PAGES / 2);
+    CHECK(report.backend.free_blocks[0] >= PAGES / 2);
+    CHECK(report.backend.unusable_free[1] > 0.0);
+    CHECK(report.backend.external_fragmentation == report.backend.unusable_free[max_order]);
+    CHECK(report.backend.external_fragmentation > 0.0);
+
+    for (int i = 1; i < PAGES; i += 2) backend_free(pages[i]);
+    report = frag_analyze();
+    CHECK(report.backend.free_pages == report.backend.committed_pages);
+    CHECK(report.backend.external_fragmentation == 0.0);
+
+    // Classe de 128 bytes com pedidos de 100: 1 - 100/128 de fragmentação interna
+    int index = -1;
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        if (report.pools.classes[i].block_size == pool_class_size(REQUEST_SIZE)) index = i;
+    }
+    CHECK(index >= 0);
+
+    void *blocks[POOL_BLOCKS];
+    for (int i = 0; i < POOL_BLOCKS; i++) blocks[i] = palloc(REQUEST_SIZE);
+
+    report = frag_analyze();
+    Pool_Class_Fragmentation *pool_class = &report.pools.classes[index];
+    double expected = 1.0 - (double)REQUEST_SIZE / (double)pool_class_size(REQUEST_SIZE);
+    CHECK(pool_class->live_blocks == POOL_BLOCKS);
+    CHECK(pool_class->capacity >= POOL_BLOCKS);
+    CHECK(pool_class->internal_fragmentation > expected - 0.001 && pool_class->internal_fragmentation < expected + 0.001);
+
+    u64 chunks = 0;
+    for (int b = 0; b < POOL_OCCUPANCY_BUCKETS; b++) chunks += pool_class->occupancy[b];
+    CHECK(chunks == pool_class->chunks);
+
+    // Page map: cabeçalho e uma linha por bloco de ordem máxima, 2 caracteres por página
+    FILE *out = tmpfile();
+    CHECK(out != NULL);
+    CHECK(frag_export_page_map(out));
+    rewind(out);
+
+    static char line[1 << 16];
+    CHECK(fgets(line, sizeof(line), out) != NULL);
+    int version = 0;
+    size_t page_size = 0, map_pages = 0;
+    u32 map_order = 0;
+    CHECK(sscanf(line, "pagemap %d page_size=%zu max_order=%u pages=%zu", &version, &page_size, &map_order, &map_pages) == 4);
+    CHECK(version == FRAG_MAP_VERSION);
+    CHECK(page_size == backend_page_size() && map_order == max_order);
+    CHECK(map_pages > 0);
+
+    size_t rows = 0, pool_pages = 0;
+    while (fgets(line, sizeof(line), out) != NULL) {
+        size_t first_page = 0;
+        char cells[1 << 12];
+        CHECK(sscanf(line, "%zu %4095s", &first_page, cells) == 2);
+        CHECK(first_page == rows << max_order);
+        CHECK(strlen(cells) == 2 * ((size_t)1 << max_order) || first_page + strlen(cells) / 2 == map_pages);
+
+        for (size_t c = 0; cells[c] != '\0'; c += 2) {
+            CHECK(strchr(".APHDN", cells[c]) != NULL);
+            CHECK(cells[c + 1] >= '0' && cells[c + 1] <= '9');
+            if (cells[c] == '.') CHECK(cells[c + 1] == '0');
+            if (cells[c] == 'P') pool_pages++;
+        }
+        rows++;
+    }
+    CHECK(rows == (map_pages + ((size_t)1 << max_order) - 1) >> max_order);
+    CHECK(pool_pages > 0);
+    fclose(out);
+
+    for (int i = 0; i < POOL_BLOCKS; i++) pool_free(blocks[i]);
+
+    TEST_PASS("fragmentation");
+    return 0;
+}
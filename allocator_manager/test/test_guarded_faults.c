@@ -0,0 +1,112 @@
+#include <setjmp.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "guarded_pool.h"
+#include "test_utils.h"
+
+/*
+Guarded pool: overflow e use-after-free em blocos amostrados falham com relatório, e falhas fora
+da região continuam indo para o handler do programa, sem desinstalar o do guarded pool.
+ */
+
+static sigjmp_buf recover_point;
+static volatile sig_atomic_t own_faults = 0;
+static void *volatile own_fault_address = NULL;
+
+static void own_handler(int signal, siginfo_t *info, void *context) {
+    (void)signal;
+    (void)context;
+    own_faults++;
+    own_fault_address = info->si_addr;
+    siglongjmp(recover_point, 1);
+}
+
+static char *guarded_block(size_t size) {
+    for (;;) {
+        char *ptr = palloc(size);
+        if (guarded_owns(ptr)) return ptr;
+        pool_free(ptr);
+    }
+}
+
+/*
+Roda 'mode' num processo filho com o stderr num pipe. O filho volta pelo own_handler (o handler anterior)
+depois do relatório e confere o endereço da falha.
+ */
+static void expect_report(const char *mode, const char *expected) {
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+
+    pid_t child = fork();
+    CHECK(child >= 0);
+
+    if (child == 0) {
+        dup2(fds[1], STDERR_FILENO);
+        close(fds[0]);
+
+        char *ptr = guarded_block(33);
+        volatile char *target = (strcmp(mode, "overflow") == 0) ? ptr + 48 : ptr;
+        if (strcmp(mode, "use-after-free") == 0) pool_free(ptr);
+
+        if (sigsetjmp(recover_point, 1) == 0) {
+            *target = 1;
+            _exit(2);
+        }
+        _exit((own_fault_address == (void*)target) ? 0 : 3);
+    }
+
+    close(fds[1]);
+    char report[4096];
+    size_t length = 0;
+    ssize_t n;
+    while ((n = read(fds[0], report + length, sizeof(report) - 1 - length)) > 0) length += (size_t)n;
+    report[length] = '\0';
+    close(fds[0]);
+
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(strstr(report, expected) != NULL);
+    CHECK(strstr(report, "Allocated by thread") != NULL);
+}
+
+int main(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = own_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    CHECK(sigaction(SIGSEGV, &action, NULL) == 0);
+
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+    CHECK(guarded_pool_init(16, 4));
+
+    // Falhas do próprio programa, fora da região: o handler dele recebe as duas
+    char *outside = mmap(NULL, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(outside != MAP_FAILED);
+    for (int i = 0; i < 2; i++) {
+        if (sigsetjmp(recover_point, 1) == 0) {
+            *(volatile char*)outside = 1;
+        }
+        CHECK(own_faults == i + 1);
+        CHECK(own_fault_address == outside);
+    }
+
+    struct sigaction current;
+    CHECK(sigaction(SIGSEGV, NULL, &current) == 0);
+    CHECK(current.sa_sigaction != own_handler);
+
+    expect_report("overflow", "buffer overflow");
+    expect_report("use-after-free", "use-after-free");
+
+    TEST_PASS("guarded_faults");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <pthread.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "guarded_pool.h"
+#include "test_utils.h"
+
+/*
+Amostragem do guarded pool: uma thread nova não leva um slot no primeiro palloc,
+e a taxa fica perto de 1 em sample_rate.
+ */
+
+#define SAMPLE_RATE 50
+#define THREADS 64
+#define ALLOCS_PER_THREAD 4000
+
+static void *first_alloc_worker(void *arg) {
+    (void)arg;
+    void *ptr = palloc(64);
+    bool guarded = guarded_owns(ptr);
+    pool_free(ptr);
+    return (void*)(uintptr_t)guarded;
+}
+
+static void *churn_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < ALLOCS_PER_THREAD; i++) pool_free(palloc(48));
+    return NULL;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+    CHECK(guarded_pool_init(THREADS, SAMPLE_RATE));
+
+    // Thread por requisição: o primeiro palloc de cada thread nunca vai para a região guardada
+    for (int i = 0; i < THREADS; i++) {
+        pthread_t thread;
+        void *guarded = NULL;
+        pthread_create(&thread, NULL, first_alloc_worker, NULL);
+        pthread_join(thread, &guarded);
+        CHECK(guarded == NULL);
+    }
+    CHECK(guarded_pool_get_stats().allocs == 0);
+
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) pthread_create(&threads[i], NULL, churn_worker, NULL);
+    for (int i = 0; i < 4; i++) pthread_join(threads[i], NULL);
+
+    Guarded_Stats stats = guarded_pool_get_stats();
+    u64 expected = 4 * ALLOCS_PER_THREAD / SAMPLE_RATE;
+    CHECK(stats.allocs + stats.skipped >= expected / 2);
+    CHECK(stats.allocs + stats.skipped <= expected * 2);
+    CHECK(stats.allocs == stats.frees);
+    CHECK(stats.in_use == 0);
+
+    TEST_PASS("guarded_sampling");
+    return 0;
+}
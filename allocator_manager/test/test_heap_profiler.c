@@ -0,0 +1,81 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "heap_profiler.h"
+#include "test_utils.h"
+
+/*
+Profiler de heap: com 32 MB vivos e intervalo médio de 64 KB, a soma dos pesos do dump fica perto do
+total vivo (estimativa sem viés), a pilha da função que alocou aparece no formato collapsed, e objetos
+liberados saem do dump.
+ */
+
+#define BLOCK_SIZE 1024
+#define BLOCK_COUNT (32 * 1024)
+#define SAMPLE_INTERVAL (64 * 1024)
+
+static void *blocks[BLOCK_COUNT];
+
+// Pilha reconhecível no dump (-rdynamic exporta o símbolo)
+__attribute__((noinline)) void heap_test_allocation_site() {
+    for (int i = 0; i < BLOCK_COUNT; i++) {
+        blocks[i] = palloc(BLOCK_SIZE);
+        CHECK(blocks[i] != NULL);
+    }
+}
+
+// Soma os bytes de todas as linhas do dump; conta as que passam pelo símbolo
+static u64 dump_total(const char *symbol, u64 *symbol_bytes) {
+    FILE *out = tmpfile();
+    CHECK(out != NULL);
+    CHECK(heap_profiler_dump_collapsed(out));
+    rewind(out);
+
+    u64 total = 0;
+    *symbol_bytes = 0;
+    static char line[1 << 16];
+    while (fgets(line, sizeof(line), out) != NULL) {
+        char *space = strrchr(line, ' ');
+        CHECK(space != NULL);
+        u64 bytes = strtoull(space + 1, NULL, 10);
+        total += bytes;
+        if (strstr(line, symbol) != NULL) *symbol_bytes += bytes;
+    }
+
+    fclose(out);
+    return total;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+
+    CHECK(heap_profiler_start(SAMPLE_INTERVAL));
+    heap_test_allocation_site();
+
+    u64 live = (u64)BLOCK_SIZE * BLOCK_COUNT;
+    u64 site_bytes = 0;
+    u64 estimate = dump_total("heap_test_allocation_site", &site_bytes);
+
+    // ~512 amostras: desvio padrão ~4.4%, margem de 25%
+    CHECK(estimate > live - live / 4 && estimate < live + live / 4);
+    CHECK(site_bytes > estimate / 2);
+
+    // Metade liberada: a estimativa cai junto
+    for (int i = 0; i < BLOCK_COUNT; i += 2) pool_free(blocks[i]);
+    u64 half = dump_total("heap_test_allocation_site", &site_bytes);
+    CHECK(half > live / 2 - live / 6 && half < live / 2 + live / 6);
+
+    for (int i = 1; i < BLOCK_COUNT; i += 2) pool_free(blocks[i]);
+    CHECK(dump_total("heap_test_allocation_site", &site_bytes) == 0);
+
+    heap_profiler_stop();
+    void *after = palloc(BLOCK_SIZE);
+    CHECK(dump_total("heap_test_allocation_site", &site_bytes) == 0);
+    pool_free(after);
+
+    TEST_PASS("heap_profiler");
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "backend_manager.h"
+#include "test_utils.h"
+
+/*
+Coalescing tardio (engine BINS): ciclos alloc/free da mesma ordem são atendidos pelo cache sem
+split/merge; desligado, cada free funde até a ordem máxima. Desligar esvazia o cache e deixa as
+páginas livres em blocos de ordem máxima.
+ */
+
+#define ROUNDS 1000
+
+static void alloc_free_rounds(size_t size) {
+    for (int i = 0; i < ROUNDS; i++) {
+        void *block = backend_alloc(size, OWNER_HEAP);
+        CHECK(block != NULL);
+        backend_free(block);
+    }
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+
+    size_t page_size = backend_page_size();
+
+    backend_set_lazy_coalescing(true);
+    Backend_Coalesce_Stats before = backend_get_coalesce_stats();
+    alloc_free_rounds(page_size);
+    Backend_Coalesce_Stats lazy = backend_get_coalesce_stats();
+
+    CHECK(lazy.deferred_frees - before.deferred_frees == ROUNDS);
+    CHECK(lazy.lazy_hits - before.lazy_hits >= ROUNDS - 1);
+    CHECK(lazy.splits - before.splits <= backend_max_order());
+    CHECK(lazy.merges == before.merges);
+
+    // Desligar funde o que estava no cache: tudo livre volta à ordem máxima
+    backend_set_lazy_coalescing(false);
+    Backend_Fragmentation frag = backend_get_fragmentation();
+    CHECK(frag.free_pages == frag.committed_pages);
+    CHECK((frag.free_blocks[backend_max_order()] << backend_max_order()) == frag.committed_pages);
+
+    before = backend_get_coalesce_stats();
+    alloc_free_rounds(page_size);
+    Backend_Coalesce_Stats eager = backend_get_coalesce_stats();
+
+    CHECK(eager.deferred_frees == before.deferred_frees);
+    CHECK(eager.lazy_hits == before.lazy_hits);
+    CHECK(eager.splits - before.splits >= (u64)ROUNDS * backend_max_order());
+    CHECK(eager.merges - before.merges >= (u64)ROUNDS * backend_max_order());
+
+    TEST_PASS("lazy_coalescing");
+    return 0;
+}
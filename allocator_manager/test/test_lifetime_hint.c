@@ -0,0 +1,65 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+palloc_hint: blocos de vida longa saem de pools próprias. Num padrão de muitos temporários com um
+sobrevivente a cada SURVIVOR_EVERY, os sobreviventes prendem chunks das pools curtas (pinned) só
+quando alocados sem o hint.
+ */
+
+#define BLOCK_SIZE 64
+#define ROUNDS 3
+#define BLOCKS_PER_ROUND 20000
+#define SURVIVOR_EVERY 100
+#define SURVIVORS (ROUNDS * BLOCKS_PER_ROUND / SURVIVOR_EVERY)
+
+static void *blocks[BLOCKS_PER_ROUND];
+static void *survivors[SURVIVORS];
+
+// Retorna a quantidade de sobreviventes guardados
+static int mixed_workload(bool use_hint) {
+    int kept = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BLOCKS_PER_ROUND; i++) {
+            if (i % SURVIVOR_EVERY == 0) {
+                survivors[kept] = use_hint ? palloc_hint(BLOCK_SIZE, LIFETIME_LONG) : palloc(BLOCK_SIZE);
+                CHECK(survivors[kept] != NULL);
+                kept++;
+            }
+            blocks[i] = palloc(BLOCK_SIZE);
+            CHECK(blocks[i] != NULL);
+        }
+        for (int i = 0; i < BLOCKS_PER_ROUND; i++) pool_free(blocks[i]);
+    }
+    return kept;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)128 << 20;
+    CHECK(backend_init(&config));
+
+    // Sem hint: sobreviventes espalhados pelos chunks dos temporários
+    int kept = mixed_workload(false);
+    Pool_Lifetime_Stats plain = pool_get_lifetime_stats();
+    CHECK(plain.live_blocks[LIFETIME_SHORT] == (u64)kept);
+    CHECK(plain.live_blocks[LIFETIME_LONG] == 0);
+    CHECK(plain.pinned_chunks[LIFETIME_SHORT] > 0);
+    CHECK(plain.pinned_bytes[LIFETIME_SHORT] > 0);
+    for (int i = 0; i < kept; i++) pool_free(survivors[i]);
+
+    // Com hint: os sobreviventes ficam juntos nas pools longas, nenhum chunk curto preso
+    kept = mixed_workload(true);
+    Pool_Lifetime_Stats hinted = pool_get_lifetime_stats();
+    CHECK(hinted.live_blocks[LIFETIME_LONG] == (u64)kept);
+    CHECK(hinted.live_blocks[LIFETIME_SHORT] == 0);
+    CHECK(hinted.pinned_chunks[LIFETIME_SHORT] == 0);
+    CHECK(hinted.chunks[LIFETIME_LONG] < plain.pinned_chunks[LIFETIME_SHORT]);
+    for (int i = 0; i < kept; i++) pool_free(survivors[i]);
+
+    CHECK(pool_get_lifetime_stats().live_blocks[LIFETIME_LONG] == 0);
+
+    TEST_PASS("lifetime_hint");
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Classes do palloc: potências de 2 até 512 e MEDIUM_CLASSES_PER_DOUBLING passos por dobra até 16 KB.
+Tamanho -> classe entrega a menor classe que comporta o pedido, e classe -> tamanho -> classe é identidade.
+ */
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    // Tabela esperada, montada independente do cálculo do pool.c
+    size_t classes[MAX_GENERIC_POOLS];
+    int count = 0;
+    for (size_t size = 8; size <= MAX_SMALL_POOL_BLOCK_SIZE; size <<= 1) classes[count++] = size;
+    for (size_t base = MAX_SMALL_POOL_BLOCK_SIZE; base < MAX_POOL_BLOCK_SIZE; base <<= 1) {
+        for (int step = 1; step <= MEDIUM_CLASSES_PER_DOUBLING; step++) {
+            classes[count++] = base + step * (base / MEDIUM_CLASSES_PER_DOUBLING);
+        }
+    }
+    CHECK(count == MAX_GENERIC_POOLS);
+    CHECK(classes[count - 1] == MAX_POOL_BLOCK_SIZE);
+
+    // Tamanho -> classe: a menor que comporta
+    int expected = 0;
+    for (size_t size = 1; size <= MAX_POOL_BLOCK_SIZE; size++) {
+        while (classes[expected] < size) expected++;
+        CHECK(pool_class_size(size) == classes[expected]);
+    }
+    CHECK(pool_class_size(MAX_POOL_BLOCK_SIZE + 1) == 0);
+
+    // Classe -> tamanho -> classe, e o bloco entregue tem exatamente o tamanho da classe
+    Pool_Fragmentation frag = pool_get_fragmentation();
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        CHECK(pool_class_size(classes[i]) == classes[i]);
+        CHECK(frag.classes[i].block_size == classes[i]);
+
+        void *block = palloc(classes[i]);
+        CHECK(block != NULL);
+        CHECK(pool_usable_size(block) == classes[i]);
+        pool_free(block);
+    }
+
+    TEST_PASS("medium_classes");
+    return 0;
+}
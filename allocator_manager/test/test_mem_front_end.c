@@ -0,0 +1,78 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "mem.h"
+#include "mm_stats.h"
+#include "test_utils.h"
+
+/*
+mem_alloc/mem_free/mem_realloc: roteamento pelo dono do Page_Descriptor (POOL, HEAP, ARENA, huge)
+e realloc dentro da mesma classe devolvendo o próprio ponteiro; blocos de vida longa continuam longos.
+ */
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    size_t page_size = backend_page_size();
+    size_t max_block = page_size << backend_max_order();
+
+    // Um tamanho de cada caminho: pool, bloco do backend, huge
+    size_t sizes[] = { 24, MAX_POOL_BLOCK_SIZE, MAX_POOL_BLOCK_SIZE + 1, max_block, max_block + 1 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char *ptr = mem_alloc(sizes[i]);
+        CHECK(ptr != NULL);
+        CHECK(mem_usable_size(ptr) >= sizes[i]);
+        memset(ptr, 0x5A, sizes[i]);
+        mem_free(ptr);
+    }
+
+    // OWNER_ARENA também volta pelo backend
+    void *arena = backend_alloc(2 * page_size, OWNER_ARENA);
+    CHECK(arena != NULL);
+    CHECK(mm_stats_get().owners[OWNER_ARENA].committed_pages == 2);
+    CHECK(mem_usable_size(arena) == 2 * page_size);
+    mem_free(arena);
+    CHECK(mm_stats_get().owners[OWNER_ARENA].committed_pages == 0);
+
+    // Mesma classe: o próprio ponteiro; classe diferente: move e preserva o conteúdo
+    char *ptr = mem_alloc(100);
+    size_t usable = mem_usable_size(ptr);
+    memset(ptr, 0x11, 100);
+    CHECK(mem_realloc(ptr, usable) == ptr);
+
+    char *moved = mem_realloc(ptr, MAX_POOL_BLOCK_SIZE + 1);
+    CHECK(moved != NULL && moved != ptr);
+    for (int i = 0; i < 100; i++) CHECK(moved[i] == 0x11);
+
+    // Mesmo bloco do backend: as duas ordens arredondam para o mesmo tamanho
+    CHECK(mem_realloc(moved, mem_usable_size(moved)) == moved);
+    char *shrunk = mem_realloc(moved, 50);
+    CHECK(shrunk != moved);
+    for (int i = 0; i < 50; i++) CHECK(shrunk[i] == 0x11);
+    CHECK(mem_realloc(shrunk, 0) == NULL);
+
+    // Bloco de vida longa continua numa pool de vida longa ao mudar de classe
+    Pool_Lifetime_Stats before = pool_get_lifetime_stats();
+    char *cached = palloc_hint(64, LIFETIME_LONG);
+    memset(cached, 0x22, 64);
+    char *grown = mem_realloc(cached, 1000);
+    CHECK(grown != NULL && grown != cached);
+    for (int i = 0; i < 64; i++) CHECK(grown[i] == 0x22);
+    Pool_Lifetime_Stats after = pool_get_lifetime_stats();
+    CHECK(after.live_blocks[LIFETIME_LONG] == before.live_blocks[LIFETIME_LONG] + 1);
+    CHECK(after.live_blocks[LIFETIME_SHORT] == before.live_blocks[LIFETIME_SHORT]);
+    mem_free(grown);
+
+    char *zeroed = mem_calloc(64, 64);
+    CHECK(zeroed != NULL);
+    for (int i = 0; i < 64 * 64; i++) CHECK(zeroed[i] == 0);
+    mem_free(zeroed);
+
+    CHECK(mm_stats_get().owners[OWNER_HEAP].committed_pages == 0);
+
+    TEST_PASS("mem_front_end");
+    return 0;
+}
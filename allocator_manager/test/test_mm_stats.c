@@ -0,0 +1,84 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "mem.h"
+#include "mm_stats.h"
+#include "test_utils.h"
+
+/*
+mm_stats_get(): totais por classe e páginas comprometidas/usadas por Page_Owner.
+Para OWNER_HEAP, used_pages são as páginas pedidas (3 páginas num bloco de ordem 2: 4 comprometidas, 3 usadas).
+ */
+
+static Mm_Stats_Class *class_of(Mm_Stats *stats, size_t size) {
+    size_t block_size = pool_class_size(size);
+    for (int i = 0; i < MAX_GENERIC_POOLS; i++) {
+        if (stats->classes[i].block_size == block_size) return &stats->classes[i];
+    }
+    return NULL;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    size_t page_size = backend_page_size();
+    Mm_Stats before = mm_stats_get();
+
+    // Classes: 100 allocs, 40 frees de 24 bytes
+    void *blocks[100];
+    for (int i = 0; i < 100; i++) blocks[i] = palloc(24);
+    for (int i = 0; i < 40; i++) pool_free(blocks[i]);
+
+    // Heap: 3 páginas (ordem 2) e uma huge acima da ordem máxima (+1 página de header)
+    void *heap = backend_alloc(3 * page_size, OWNER_HEAP);
+    size_t huge_pages = ((size_t)1 << backend_max_order()) + 8;
+    void *huge = backend_alloc(huge_pages * page_size, OWNER_HEAP);
+    CHECK(heap != NULL && huge != NULL);
+
+    Mm_Stats stats = mm_stats_get();
+    Mm_Stats_Class *class = class_of(&stats, 24);
+    Mm_Stats_Class *class_before = class_of(&before, 24);
+    CHECK(class != NULL && class_before != NULL);
+    CHECK(class->allocs - class_before->allocs == 100);
+    CHECK(class->frees - class_before->frees == 40);
+    CHECK(class->live_blocks == 60);
+    CHECK(class->requested_bytes - class_before->requested_bytes == 100 * 24);
+
+    Mm_Stats_Owner *heap_owner = &stats.owners[OWNER_HEAP];
+    CHECK(heap_owner->committed_pages == 4 + huge_pages + 1);
+    CHECK(heap_owner->used_pages == 3 + huge_pages);
+    CHECK(stats.huge_allocs == 1);
+    CHECK(stats.huge_bytes == (huge_pages + 1) * page_size);
+
+    Mm_Stats_Owner *pool_owner = &stats.owners[OWNER_POOL];
+    CHECK(pool_owner->committed_pages > 0);
+    CHECK(pool_owner->used_pages <= pool_owner->committed_pages);
+    CHECK(pool_owner->used_pages >= (60 * class->block_size) / page_size);
+
+    // Free do heap: as páginas saem das duas contagens, mesmo com o bloco parado no cache tardio
+    backend_free(heap);
+    backend_free(huge);
+    stats = mm_stats_get();
+    CHECK(stats.owners[OWNER_HEAP].committed_pages == 0);
+    CHECK(stats.owners[OWNER_HEAP].used_pages == 0);
+    CHECK(stats.huge_frees == 1 && stats.huge_bytes == 0);
+
+    for (int i = 40; i < 100; i++) pool_free(blocks[i]);
+    stats = mm_stats_get();
+    CHECK(class_of(&stats, 24)->live_blocks == 0);
+
+    char *json = NULL;
+    size_t json_size = 0;
+    FILE *out = open_memstream(&json, &json_size);
+    CHECK(out != NULL);
+    mm_stats_dump_json(out);
+    fclose(out);
+    CHECK(strstr(json, "\"used_pages\"") != NULL);
+    free(json);
+
+    TEST_PASS("mm_stats");
+    return 0;
+}
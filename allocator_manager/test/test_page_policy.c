@@ -0,0 +1,86 @@
+#include <stdint.h>
+
+#include "backend_manager.h"
+#include "test_utils.h"
+
+/*
+Política das Page_Bins (engine BINS): PAGE_POLICY_ADDRESS_ORDERED entrega o bloco livre de menor
+endereço, com ou sem o cache de coalescing tardio; PAGE_POLICY_LIFO entrega o último liberado.
+ */
+
+#define PAGES 64
+#define FREED 16
+
+static void *pages[PAGES];
+
+// Páginas de índice par embaralhadas: nenhuma funde com a vizinha, que continua alocada
+static const int free_order[FREED] = { 22, 6, 30, 0, 14, 26, 2, 18, 10, 28, 4, 20, 8, 24, 12, 16 };
+
+static void alloc_pages() {
+    for (int i = 0; i < PAGES; i++) {
+        pages[i] = backend_alloc(backend_page_size(), OWNER_HEAP);
+        CHECK(pages[i] != NULL);
+    }
+}
+
+static void free_pages() {
+    for (int i = 0; i < PAGES; i++) {
+        if (pages[i] != NULL) backend_free(pages[i]);
+        pages[i] = NULL;
+    }
+}
+
+// Libera as primeiras count páginas de free_order e confere que voltam em ordem crescente de endereço
+static void check_address_ordered(int count) {
+    alloc_pages();
+
+    uintptr_t lowest = UINTPTR_MAX;
+    for (int i = 0; i < count; i++) {
+        if ((uintptr_t)pages[free_order[i]] < lowest) lowest = (uintptr_t)pages[free_order[i]];
+        backend_free(pages[free_order[i]]);
+        pages[free_order[i]] = NULL;
+    }
+
+    void *reused[FREED];
+    for (int i = 0; i < count; i++) {
+        reused[i] = backend_alloc(backend_page_size(), OWNER_HEAP);
+        CHECK(reused[i] != NULL);
+        if (i == 0) CHECK((uintptr_t)reused[i] == lowest);
+        else CHECK((uintptr_t)reused[i] > (uintptr_t)reused[i - 1]);
+    }
+
+    for (int i = 0; i < count; i++) backend_free(reused[i]);
+    free_pages();
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+
+    backend_set_page_policy(PAGE_POLICY_ADDRESS_ORDERED);
+    backend_set_lazy_coalescing(false);
+    check_address_ordered(FREED);
+    // O cache é consultado antes das Page_Bins: a ordem por endereço vale dentro dele
+    backend_set_lazy_coalescing(true);
+    check_address_ordered(LAZY_COALESCE_CACHE_SIZE);
+
+    // LIFO: o último bloco liberado volta primeiro
+    backend_set_lazy_coalescing(false);
+    backend_set_page_policy(PAGE_POLICY_LIFO);
+    alloc_pages();
+    for (int i = 0; i < FREED; i++) {
+        backend_free(pages[free_order[i]]);
+    }
+    void *last_freed = pages[free_order[FREED - 1]];
+    for (int i = 0; i < FREED; i++) pages[free_order[i]] = NULL;
+
+    void *reused = backend_alloc(backend_page_size(), OWNER_HEAP);
+    CHECK(reused == last_freed);
+    backend_free(reused);
+    free_pages();
+
+    TEST_PASS("page_policy");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "percpu_cache.h"
+#include "test_utils.h"
+
+/*
+Cache por CPU: com rseq, um free seguido de palloc da mesma classe volta pelo cache (mesmo ponteiro)
+e várias threads alternando alloc/free não corrompem blocos. Sem rseq, pool_enable_percpu_cache()
+retorna false e o mesmo stress roda pelo caminho com lock.
+ */
+
+#define THREAD_COUNT 8
+#define ROUNDS 2000
+#define LIVE_BLOCKS 64
+
+static void *percpu_thread(void *arg) {
+    unsigned char tag = (unsigned char)(size_t)arg;
+    void *blocks[LIVE_BLOCKS];
+    size_t sizes[LIVE_BLOCKS];
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < LIVE_BLOCKS; i++) {
+            sizes[i] = (size_t)8 << ((round + i) % SMALL_GENERIC_POOLS);
+            blocks[i] = palloc(sizes[i]);
+            CHECK(blocks[i] != NULL);
+            memset(blocks[i], tag, sizes[i]);
+        }
+        for (int i = 0; i < LIVE_BLOCKS; i++) {
+            unsigned char *bytes = blocks[i];
+            CHECK(bytes[0] == tag && bytes[sizes[i] - 1] == tag);
+            pool_free(blocks[i]);
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    bool enabled = pool_enable_percpu_cache();
+    CHECK(enabled == percpu_cache_is_enabled());
+
+    if (enabled) {
+        void *block = palloc(64);
+        CHECK(block != NULL);
+        pool_free(block);
+        CHECK(palloc(64) == block);
+        pool_free(block);
+    } else {
+        printf("percpu_cache: rseq unavailable, testing the locked path only\n");
+    }
+
+    pthread_t threads[THREAD_COUNT];
+    for (size_t i = 0; i < THREAD_COUNT; i++) {
+        CHECK(pthread_create(&threads[i], NULL, percpu_thread, (void*)(i + 1)) == 0);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) CHECK(pthread_join(threads[i], NULL) == 0);
+
+    TEST_PASS("percpu_cache");
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Reserva de chunks vazios (histerese): lotes que sobem e descem por alguns chunks voltam a usar os
+chunks retidos, sem ir ao backend a cada rodada. Com as reservas em 0, cada rodada devolve e pede de novo.
+ */
+
+#define BATCH 600 // ~3 chunks de blocos de 64 bytes
+#define ROUNDS 100
+
+static void *blocks[BATCH];
+
+static void churn(Pool *pool) {
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BATCH; i++) {
+            blocks[i] = pool_alloc(pool);
+            CHECK(blocks[i] != NULL);
+        }
+        for (int i = 0; i < BATCH; i++) pool_free(blocks[i]);
+    }
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    // Reservas padrão: só a primeira rodada chega ao backend
+    Pool *reserved = pool_create(64);
+    CHECK(reserved != NULL);
+    Pool_Reserve_Stats before = pool_get_reserve_stats();
+    churn(reserved);
+    Pool_Reserve_Stats after = pool_get_reserve_stats();
+
+    CHECK(after.backend_refills - before.backend_refills <= 3);
+    CHECK(after.pool_reserve_hits - before.pool_reserve_hits >= ROUNDS - 1);
+    CHECK(after.global_reserve_hits - before.global_reserve_hits >= ROUNDS - 1);
+    CHECK(after.chunks_retained > before.chunks_retained);
+    CHECK(after.chunks_released == before.chunks_released);
+    pool_destroy(reserved);
+
+    // Sem reserva: todo chunk esvaziado volta ao backend e a rodada seguinte pede de novo
+    pool_set_global_chunk_reserve(0);
+    Pool *unreserved = pool_create(96);
+    CHECK(unreserved != NULL);
+    pool_set_chunk_reserve(unreserved, 0);
+
+    before = pool_get_reserve_stats();
+    churn(unreserved);
+    after = pool_get_reserve_stats();
+
+    CHECK(after.pool_reserve_hits == before.pool_reserve_hits);
+    CHECK(after.global_reserve_hits == before.global_reserve_hits);
+    CHECK(after.backend_refills - before.backend_refills >= ROUNDS);
+    CHECK(after.chunks_released - before.chunks_released >= ROUNDS);
+    pool_destroy(unreserved);
+
+    TEST_PASS("pool_chunk_reserve");
+    return 0;
+}
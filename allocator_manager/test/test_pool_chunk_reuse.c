@@ -0,0 +1,29 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+Regressão: chunks que recuperam blocos livres antes do chunk ativo precisam voltar para a fila.
+Lotes de palloc(8 KB) liberados em ordem reversa esgotavam uma reserva de 64 MB em ~30 rodadas.
+ */
+
+#define BATCH 256
+#define ROUNDS 2000
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    void *blocks[BATCH];
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BATCH; i++) {
+            blocks[i] = palloc(8192);
+            CHECK(blocks[i] != NULL);
+        }
+        for (int i = 0; i < BATCH; i++) pool_free(blocks[BATCH - 1 - i]);
+    }
+
+    TEST_PASS("pool_chunk_reuse");
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <string.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "test_utils.h"
+
+/*
+prealloc: dentro da mesma classe devolve o próprio ponteiro; entre classes (ou para o backend acima
+de MAX_POOL_BLOCK_SIZE) move preservando o conteúdo e a pool de tempo de vida do bloco original.
+ */
+
+static void fill(void *ptr, size_t size) {
+    unsigned char *bytes = ptr;
+    for (size_t i = 0; i < size; i++) bytes[i] = (unsigned char)(i * 7 + 1);
+}
+
+static bool check_fill(const void *ptr, size_t size) {
+    const unsigned char *bytes = ptr;
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i] != (unsigned char)(i * 7 + 1)) return false;
+    }
+    return true;
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    void *ptr = prealloc(NULL, 100);
+    CHECK(ptr != NULL);
+    size_t class_size = pool_usable_size(ptr);
+    CHECK(class_size == pool_class_size(100));
+    fill(ptr, 100);
+
+    // Mesma classe, crescendo e encolhendo
+    CHECK(prealloc(ptr, class_size) == ptr);
+    CHECK(prealloc(ptr, pool_class_size(100) / 2 + 1) == ptr);
+    CHECK(check_fill(ptr, 100));
+
+    // Classe maior: move e preserva o conteúdo antigo
+    void *grown = prealloc(ptr, class_size + 1);
+    CHECK(grown != NULL && grown != ptr);
+    CHECK(pool_usable_size(grown) == pool_class_size(class_size + 1));
+    CHECK(check_fill(grown, 100));
+
+    // Classe média
+    void *medium = prealloc(grown, 5000);
+    CHECK(medium != NULL && pool_usable_size(medium) >= 5000);
+    CHECK(check_fill(medium, 100));
+    fill(medium, 5000);
+
+    // Acima das pools: bloco do backend, conteúdo preservado
+    void *large = prealloc(medium, MAX_POOL_BLOCK_SIZE + 1);
+    CHECK(large != NULL);
+    CHECK(get_descriptor(large)->owner_id == OWNER_HEAP);
+    CHECK(check_fill(large, 5000));
+    backend_free(large);
+
+    // Cadeia que sai das pools: backend duas vezes, depois huge, e de volta até 0
+    void *chain = palloc(100);
+    fill(chain, 100);
+    chain = prealloc(chain, MAX_POOL_BLOCK_SIZE + 100);
+    CHECK(chain != NULL && get_descriptor(chain)->owner_id == OWNER_HEAP);
+    fill(chain, MAX_POOL_BLOCK_SIZE + 100);
+    chain = prealloc(chain, MAX_POOL_BLOCK_SIZE + 5000);
+    CHECK(chain != NULL && get_descriptor(chain)->owner_id == OWNER_HEAP);
+    CHECK(check_fill(chain, MAX_POOL_BLOCK_SIZE + 100));
+    size_t huge_size = REQUEST_SIZE_FROM_ORDER(backend_max_order()) + 1;
+    chain = prealloc(chain, huge_size);
+    CHECK(chain != NULL && is_huge_allocation(chain));
+    CHECK(check_fill(chain, MAX_POOL_BLOCK_SIZE + 100));
+    chain = prealloc(chain, huge_size + backend_page_size());
+    CHECK(chain != NULL && is_huge_allocation(chain));
+    CHECK(check_fill(chain, MAX_POOL_BLOCK_SIZE + 100));
+    chain = prealloc(chain, 64);
+    CHECK(chain != NULL && get_descriptor(chain)->owner_id == OWNER_POOL);
+    CHECK(check_fill(chain, 64));
+    CHECK(prealloc(chain, 0) == NULL);
+
+    // prealloc(ptr, 0) em blocos do backend e huge
+    void *heap_block = prealloc(palloc(100), MAX_POOL_BLOCK_SIZE + 1);
+    CHECK(heap_block != NULL);
+    CHECK(prealloc(heap_block, 0) == NULL);
+    void *huge_block = prealloc(NULL, huge_size);
+    CHECK(huge_block != NULL && is_huge_allocation(huge_block));
+    CHECK(prealloc(huge_block, 0) == NULL);
+    CHECK(backend_get_fragmentation().huge_allocations == 0);
+
+    // Encolher para outra classe trunca no tamanho novo
+    void *shrink = palloc(2000);
+    fill(shrink, 2000);
+    void *small = prealloc(shrink, 24);
+    CHECK(small != NULL && small != shrink);
+    CHECK(check_fill(small, 24));
+    CHECK(prealloc(small, 0) == NULL);
+
+    // Pool customizada: cabe no bloco -> mesmo ponteiro
+    Pool *custom = pool_create(200);
+    void *custom_block = pool_alloc(custom);
+    CHECK(prealloc(custom_block, 150) == custom_block);
+    CHECK(prealloc(custom_block, pool_usable_size(custom_block)) == custom_block);
+    pool_free(custom_block);
+
+    // Bloco de vida longa continua numa pool de vida longa ao mudar de classe
+    Pool_Lifetime_Stats before = pool_get_lifetime_stats();
+    void *cached = palloc_hint(64, LIFETIME_LONG);
+    void *moved = prealloc(cached, 1000);
+    CHECK(moved != NULL && moved != cached);
+    Pool_Lifetime_Stats after = pool_get_lifetime_stats();
+    CHECK(after.live_blocks[LIFETIME_LONG] == before.live_blocks[LIFETIME_LONG] + 1);
+    CHECK(after.live_blocks[LIFETIME_SHORT] == before.live_blocks[LIFETIME_SHORT]);
+    pool_free(moved);
+
+    TEST_PASS("prealloc");
+    return 0;
+}
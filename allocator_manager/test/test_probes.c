@@ -0,0 +1,108 @@
+#include <string.h>
+#include <elf.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "probes.h"
+#include "test_utils.h"
+
+/*
+Probes USDT: com <sys/sdt.h>, o executável leva uma nota .note.stapsdt por probe do provider
+allocator_manager; sem o header, as macros não avaliam os argumentos. Nos dois casos os caminhos
+instrumentados (split, merge, huge, refill, release) continuam funcionando.
+ */
+
+static const char *probe_names[] = {
+    "reserve_commit", "buddy_split", "buddy_merge", "huge_mmap", "huge_munmap", "pool_refill", "pool_chunk_release"
+};
+
+#ifdef MM_PROBES_ENABLED
+// Lê as notas stapsdt da seção .note.stapsdt do próprio executável e confere provider e nome de cada probe
+static void check_probe_notes() {
+    FILE *exe = fopen("/proc/self/exe", "rb");
+    CHECK(exe != NULL);
+    CHECK(fseek(exe, 0, SEEK_END) == 0);
+    long size = ftell(exe);
+    CHECK(size > 0);
+    rewind(exe);
+
+    u8 *image = malloc((size_t)size);
+    CHECK(image != NULL);
+    CHECK(fread(image, 1, (size_t)size, exe) == (size_t)size);
+    fclose(exe);
+
+    Elf64_Ehdr *header = (Elf64_Ehdr*)image;
+    CHECK(memcmp(header->e_ident, ELFMAG, SELFMAG) == 0 && header->e_ident[EI_CLASS] == ELFCLASS64);
+    Elf64_Shdr *sections = (Elf64_Shdr*)(image + header->e_shoff);
+    const char *names = (const char*)(image + sections[header->e_shstrndx].sh_offset);
+
+    bool found[sizeof(probe_names) / sizeof(probe_names[0])] = {0};
+    for (u32 s = 0; s < header->e_shnum; s++) {
+        if (strcmp(names + sections[s].sh_name, ".note.stapsdt") != 0) continue;
+
+        u8 *note = image + sections[s].sh_offset;
+        u8 *end = note + sections[s].sh_size;
+        while (note < end) {
+            Elf64_Nhdr *nhdr = (Elf64_Nhdr*)note;
+            const char *owner = (const char*)(note + sizeof(Elf64_Nhdr));
+            u8 *desc = note + sizeof(Elf64_Nhdr) + ((nhdr->n_namesz + 3) & ~3u);
+
+            // desc: pc, base, semáforo (3 endereços), depois "provider\0nome\0argumentos\0"
+            if (strcmp(owner, "stapsdt") == 0) {
+                const char *provider = (const char*)(desc + 3 * sizeof(u64));
+                const char *name = provider + strlen(provider) + 1;
+                CHECK(strcmp(provider, "allocator_manager") == 0);
+                for (size_t i = 0; i < sizeof(probe_names) / sizeof(probe_names[0]); i++) {
+                    if (strcmp(name, probe_names[i]) == 0) found[i] = true;
+                }
+            }
+            note = desc + ((nhdr->n_descsz + 3) & ~3u);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(probe_names) / sizeof(probe_names[0]); i++) CHECK(found[i]);
+    free(image);
+}
+#endif
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+    backend_set_lazy_coalescing(false);
+
+#ifdef MM_PROBES_ENABLED
+    check_probe_notes();
+#else
+    // Sem probes: os argumentos não são avaliados (sizeof)
+    int evaluated = 0;
+    MM_PROBE3(buddy_split, evaluated++, evaluated++, evaluated++);
+    MM_PROBE4(pool_refill, evaluated++, evaluated++, evaluated++, evaluated++);
+    CHECK(evaluated == 0);
+    (void)probe_names;
+    printf("probes: <sys/sdt.h> unavailable, testing the disabled macros only\n");
+#endif
+
+    // Split e merge, huge e refill/release das pools passando pelos probes
+    void *page = backend_alloc(backend_page_size(), OWNER_HEAP);
+    void *huge = backend_alloc(REQUEST_SIZE_FROM_ORDER(backend_max_order()) + 1, OWNER_HEAP);
+    CHECK(page != NULL && huge != NULL);
+    backend_free(huge);
+    backend_free(page);
+
+    Backend_Fragmentation frag = backend_get_fragmentation();
+    CHECK(frag.free_pages == frag.committed_pages);
+    CHECK(frag.huge_allocations == 0);
+
+    pool_set_global_chunk_reserve(0);
+    Pool *pool = pool_create(256);
+    pool_set_chunk_reserve(pool, 0);
+    static void *blocks[4096];
+    for (int i = 0; i < 4096; i++) CHECK((blocks[i] = pool_alloc(pool)) != NULL);
+    for (int i = 4095; i >= 0; i--) pool_free(blocks[i]);
+    pool_destroy(pool);
+
+    TEST_PASS("probes");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "backend_manager.h"
+#include "pool.h"
+#include "mm_stats.h"
+#include "test_utils.h"
+
+/*
+Contadores dos caminhos lentos: cada caminho conta um evento por passagem, split/merge somam a
+profundidade em ordens, e mm_slow_path_reset() zera o snapshot seguinte sem parar as threads.
+ */
+
+static Mm_Slow_Path_Stats slow_path(Mm_Slow_Path path) {
+    return mm_slow_path_snapshot().paths[path];
+}
+
+static void check_all_zero() {
+    Mm_Slow_Path_Snapshot snapshot = mm_slow_path_snapshot();
+    for (int p = 0; p < MM_SLOW_PATH_COUNT; p++) {
+        CHECK(snapshot.paths[p].events == 0);
+        CHECK(snapshot.paths[p].depth == 0);
+        CHECK(snapshot.paths[p].total_ns == 0);
+    }
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    config.engine = BACKEND_ENGINE_BINS;
+    CHECK(backend_init(&config));
+    backend_set_lazy_coalescing(false);
+
+    u32 max_order = backend_max_order();
+    mm_slow_path_reset();
+    check_all_zero();
+
+    // Primeira página: commit de um bloco de ordem máxima e split até a ordem 0
+    void *page = backend_alloc(backend_page_size(), OWNER_HEAP);
+    CHECK(page != NULL);
+    CHECK(slow_path(MM_SLOW_RESERVE_COMMIT).events == 1);
+    CHECK(slow_path(MM_SLOW_SPLIT).events == 1);
+    CHECK(slow_path(MM_SLOW_SPLIT).depth == max_order);
+
+    // Free: funde de volta até a ordem máxima
+    backend_free(page);
+    CHECK(slow_path(MM_SLOW_MERGE).events == 1);
+    CHECK(slow_path(MM_SLOW_MERGE).depth == max_order);
+
+    // Mesma ordem de novo: já há bloco de ordem máxima livre, sem commit
+    page = backend_alloc(REQUEST_SIZE_FROM_ORDER(max_order), OWNER_HEAP);
+    CHECK(slow_path(MM_SLOW_RESERVE_COMMIT).events == 1);
+    CHECK(slow_path(MM_SLOW_SPLIT).events == 1);
+    backend_free(page);
+
+    void *huge = backend_alloc(REQUEST_SIZE_FROM_ORDER(max_order) + 1, OWNER_HEAP);
+    CHECK(huge != NULL);
+    backend_free(huge);
+    CHECK(slow_path(MM_SLOW_HUGE_MMAP).events == 1);
+    CHECK(slow_path(MM_SLOW_HUGE_MUNMAP).events == 1);
+
+    void *block = palloc(64);
+    CHECK(block != NULL);
+    CHECK(slow_path(MM_SLOW_POOL_REFILL).events >= 1);
+    pool_free(block);
+
+    // Trocar o chunk ativo por um da lista que ganhou um bloco livre não é refill
+    Pool *pool = pool_create(256);
+    CHECK(pool != NULL);
+    static void *blocks[4096];
+    for (int i = 0; i < 1000; i++) CHECK((blocks[i] = pool_alloc(pool)) != NULL);
+    pool_free(blocks[0]);
+
+    u64 refills = slow_path(MM_SLOW_POOL_REFILL).events;
+    int taken = 1000;
+    void *reused = NULL;
+    while (reused != blocks[0] && taken < 4096) {
+        reused = pool_alloc(pool);
+        CHECK(reused != NULL);
+        blocks[taken++] = reused;
+    }
+    CHECK(reused == blocks[0]);
+    CHECK(slow_path(MM_SLOW_POOL_REFILL).events == refills);
+    for (int i = 1; i < taken; i++) pool_free(blocks[i]);
+    pool_destroy(pool);
+
+    Mm_Slow_Path_Snapshot snapshot = mm_slow_path_snapshot();
+    CHECK(snapshot.elapsed_ns > 0);
+#if MM_SLOW_PATH_TIMING
+    CHECK(snapshot.paths[MM_SLOW_HUGE_MMAP].total_ns > 0);
+    CHECK(snapshot.paths[MM_SLOW_POOL_REFILL].total_ns > 0);
+#endif
+
+    for (int p = 0; p < MM_SLOW_PATH_COUNT; p++) CHECK(mm_slow_path_name((Mm_Slow_Path)p) != NULL);
+
+    // Reset: a base passa a ser a soma atual
+    mm_slow_path_reset();
+    check_all_zero();
+
+    TEST_PASS("slow_paths");
+    return 0;
+}
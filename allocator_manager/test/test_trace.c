@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "backend_manager.h"
+#include "pool.h"
+#include "trace.h"
+#include "test_utils.h"
+
+/*
+Trace: uma sessão gravada sobrevive a trace_stop() + trace_load() com operações, flags, tamanhos
+e pares alloc/free intactos; uma segunda sessão no mesmo processo recomeça os timestamps do zero.
+ */
+
+#define SESSION_LIMIT_NS (60ULL * 1000000000ULL)
+
+static Trace_Event *record_session(const char *path, void **ptrs, size_t *count) {
+    CHECK(trace_start(path, 4 << 20));
+
+    ptrs[0] = palloc(24);
+    ptrs[1] = pcalloc(40);
+    ptrs[2] = palloc_hint(100, LIFETIME_LONG);
+    ptrs[3] = backend_alloc(3 * backend_page_size(), OWNER_HEAP);
+    pool_free(ptrs[0]);
+    pool_free(ptrs[1]);
+    pool_free(ptrs[2]);
+    backend_free(ptrs[3]);
+
+    trace_stop();
+
+    u32 threads = 0;
+    Trace_Event *events = trace_load(path, count, &threads);
+    CHECK(events != NULL);
+    CHECK(threads == 1);
+    return events;
+}
+
+static void check_session(Trace_Event *events, size_t count, void **ptrs) {
+    CHECK(count == 8);
+
+    u8 ops[8] = {
+        TRACE_OP_PALLOC,
+        TRACE_OP_PALLOC | TRACE_FLAG_ZEROED,
+        TRACE_OP_PALLOC | TRACE_FLAG_LONG_LIVED,
+        TRACE_OP_BACKEND_ALLOC | (OWNER_HEAP << TRACE_OWNER_SHIFT),
+        TRACE_OP_POOL_FREE,
+        TRACE_OP_POOL_FREE,
+        TRACE_OP_POOL_FREE,
+        TRACE_OP_BACKEND_FREE | (OWNER_HEAP << TRACE_OWNER_SHIFT),
+    };
+    u64 sizes[4] = { 24, 40, 100, 3 * backend_page_size() };
+
+    for (size_t i = 0; i < count; i++) {
+        CHECK(events[i].op == ops[i]);
+        CHECK(events[i].address == (u64)(uintptr_t)ptrs[i % 4]);
+        if (i < 4) CHECK(events[i].size == sizes[i]);
+        if (i > 0) CHECK(events[i].timestamp >= events[i - 1].timestamp);
+        CHECK(events[i].timestamp < SESSION_LIMIT_NS);
+    }
+}
+
+int main(void) {
+    Backend_Config config = backend_default_config();
+    config.reserve_size = (size_t)64 << 20;
+    CHECK(backend_init(&config));
+
+    char path[] = "/tmp/test_trace_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    void *ptrs[4];
+    size_t count = 0;
+
+    Trace_Event *events = record_session(path, ptrs, &count);
+    check_session(events, count, ptrs);
+    trace_free_events(events, count);
+
+    // Segunda sessão: os timestamps são relativos ao novo trace_start()
+    events = record_session(path, ptrs, &count);
+    check_session(events, count, ptrs);
+    trace_free_events(events, count);
+
+    unlink(path);
+    TEST_PASS("trace");
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ==============================
+MACROS DOS TESTES
+==============================
+Independentes de assert(): o build padrão usa -DNDEBUG.
+Cada teste é um executável (bin/test_...) que sai com 1 na primeira falha.
+*/
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+#define TEST_PASS(name) printf("OK %s\n", name)